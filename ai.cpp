@@ -0,0 +1,364 @@
+#include "ai.h"
+#include "opening_book.h"
+#include "parallel.h"
+#include "solved_cache.h"
+#include "trace.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Evaluation weights and the centre-first order are tuned for Connect Four
+static_assert(Board::CONNECT == 4 && COLS == 7, "AI assumes the standard board");
+
+// Columns searched centre-first: central discs take part in more lines
+constexpr int MOVE_ORDER[COLS] = {3, 2, 4, 1, 5, 0, 6};
+
+// Nodes a thread searches between checks of the shared limits
+constexpr std::uint64_t NODE_CHECK_INTERVAL = 1024;
+
+using SearchClock = std::chrono::steady_clock;
+
+// Shared by every search thread (and by concurrent single-threaded searches)
+TranspositionTable g_table;
+std::once_flag g_tableAllocated;
+
+// Forwards completed iterations to the caller's callback, deepest first wins
+struct IterationReporter {
+    const AIProgress* callback;
+    const std::atomic<std::uint64_t>* sharedNodes;
+    std::mutex lock;
+    int reportedDepth;
+};
+
+// Per-thread search state; the limits are shared between Lazy SMP threads
+struct SearchContext {
+    TranspositionTable* table;              // The caller's table or the shared one
+    std::uint64_t nodes;                    // Nodes not yet added to sharedNodes
+    std::uint64_t nodeLimit;
+    std::atomic<std::uint64_t>* sharedNodes;
+    std::atomic<bool>* stop;
+    const std::atomic<bool>* cancel;        // Caller's cancel flag (may be null)
+    IterationReporter* reporter;            // Null unless the caller asked for progress
+    bool hasDeadline;
+    SearchClock::time_point deadline;
+    bool aborted;
+};
+
+/**
+ * @brief Key that uniquely identifies a position for the side to move
+ */
+std::uint64_t positionKey(std::uint64_t own, std::uint64_t occupied) {
+    return own + occupied;
+}
+
+/**
+ * @brief Static evaluation from the mover's point of view
+ *        Threat masks are maintained by Board::drop, so this is a few popcounts.
+ */
+int evaluate(const Board& board, int side) {
+    int ownThreats = __builtin_popcountll(board.openThreats(side + 1));
+    int oppThreats = __builtin_popcountll(board.openThreats(2 - side));
+    constexpr std::uint64_t centerColumn = ((std::uint64_t(1) << ROWS) - 1) << (3 * COLUMN_BITS);
+    int centre = __builtin_popcountll(board.pieces[side] & centerColumn) -
+                 __builtin_popcountll(board.pieces[1 - side] & centerColumn);
+    return 10 * (ownThreats - oppThreats) + 3 * centre;
+}
+
+/**
+ * @brief Publish this thread's node count and check every stop condition
+ * @return true if the search must stop
+ */
+bool checkLimits(SearchContext& ctx) {
+    std::uint64_t total = ctx.sharedNodes->fetch_add(ctx.nodes, std::memory_order_relaxed) + ctx.nodes;
+    ctx.nodes = 0;
+    if (total >= ctx.nodeLimit || ctx.stop->load(std::memory_order_relaxed) ||
+        (ctx.cancel && ctx.cancel->load(std::memory_order_relaxed)) ||
+        (ctx.hasDeadline && SearchClock::now() >= ctx.deadline)) {
+        ctx.stop->store(true, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+int negamax(SearchContext& ctx, const Board& board, int side, int depth, int alpha, int beta) {
+    if (++ctx.nodes >= NODE_CHECK_INTERVAL && checkLimits(ctx)) {
+        ctx.aborted = true;
+        return 0;
+    }
+    if (board.isFull()) return 0;
+
+    // Immediate win for the side to move ends the search here
+    if (board.canWinNext(side + 1)) {
+        return AI_WIN_SCORE - (board.moves + 1);
+    }
+    if (depth == 0) return evaluate(board, side);
+
+    int originalAlpha = alpha;
+    std::uint64_t key = positionKey(board.pieces[side], board.occupied());
+    TTHit hit;
+    int ttMove = -1;
+    if (ctx.table->probe(key, hit)) {
+        ttMove = hit.bestMove;
+        if (hit.depth >= depth) {
+            if (hit.bound == TT_BOUND_EXACT) return hit.score;
+            if (hit.bound == TT_BOUND_LOWER) alpha = std::max(alpha, hit.score);
+            else if (hit.bound == TT_BOUND_UPPER) beta = std::min(beta, hit.score);
+            if (alpha >= beta) return hit.score;
+        }
+    }
+
+    int bestScore = -AI_WIN_SCORE;
+    int bestMove = -1;
+    for (int i = -1; i < COLS; ++i) {
+        // Table move first, then centre-first ordering
+        int col = (i < 0) ? ttMove : MOVE_ORDER[i];
+        if (col < 0 || (i >= 0 && col == ttMove) || !board.canPlay(col)) continue;
+
+        Board child = board;
+        child.drop(col, side + 1);
+        int score = -negamax(ctx, child, 1 - side, depth - 1, -beta, -alpha);
+        if (ctx.aborted) return 0;
+
+        if (score > bestScore) {
+            bestScore = score;
+            bestMove = col;
+        }
+        alpha = std::max(alpha, score);
+        if (alpha >= beta) break;
+    }
+
+    int bound = TT_BOUND_EXACT;
+    if (bestScore <= originalAlpha) bound = TT_BOUND_UPPER;
+    else if (bestScore >= beta) bound = TT_BOUND_LOWER;
+    ctx.table->store(key, bestScore, depth, bound, bestMove);
+    return bestScore;
+}
+
+/**
+ * @brief Pass a completed iteration to the caller if no thread reported one as deep
+ */
+void reportIteration(IterationReporter& reporter, const AIResult& result) {
+    std::lock_guard<std::mutex> guard(reporter.lock);
+    if (result.depth <= reporter.reportedDepth) return;
+    reporter.reportedDepth = result.depth;
+    AIResult progress = result;
+    progress.nodes = reporter.sharedNodes->load(std::memory_order_relaxed);
+    (*reporter.callback)(progress);
+}
+
+/**
+ * @brief Iterative deepening at the root
+ * @param firstDepth Depth of the first iteration (helpers start staggered)
+ * @param rotation Rotates the root move order so helpers explore different subtrees first
+ * @param result Updated after every completed iteration
+ */
+void iterate(SearchContext& ctx, const Board& board, int player, int maxDepth,
+             int firstDepth, int rotation, AIResult& result) {
+    int side = player - 1;
+    for (int depth = firstDepth; depth <= maxDepth; ++depth) {
+        TRACE_SCOPE("search_iteration");
+        int bestScore = -AI_WIN_SCORE - 1;
+        int bestMove = -1;
+        int alpha = -AI_WIN_SCORE - 1;
+
+        // Try the previous iteration's best move first
+        int order[COLS];
+        int count = 0;
+        order[count++] = result.column;
+        for (int i = 0; i < COLS; ++i) {
+            int col = MOVE_ORDER[(i + rotation) % COLS];
+            if (col != result.column) order[count++] = col;
+        }
+
+        for (int i = 0; i < count; ++i) {
+            int col = order[i];
+            if (!board.canPlay(col)) continue;
+
+            Board child = board;
+            child.drop(col, player);
+            int score = child.hasWon(player)
+                ? AI_WIN_SCORE - child.moves
+                : -negamax(ctx, child, 1 - side, depth - 1, -AI_WIN_SCORE - 1, -alpha);
+            if (ctx.aborted) return;
+
+            if (score > bestScore) {
+                bestScore = score;
+                bestMove = col;
+            }
+            alpha = std::max(alpha, score);
+        }
+
+        result.column = bestMove;
+        result.score = bestScore;
+        result.depth = depth;
+        if (ctx.reporter) reportIteration(*ctx.reporter, result);
+
+        // A proven result cannot change at greater depth
+        if (std::abs(bestScore) >= AI_WIN_SCORE - ROWS * COLS) return;
+    }
+}
+
+} // namespace
+
+/**
+ * @brief Search for the best column with iterative-deepening negamax
+ *
+ * With config.threads > 1 this is a Lazy SMP search: helper threads run
+ * the same iterative deepening with staggered depths and rotated root
+ * ordering, and everyone shares the lock-free transposition table. The
+ * deepest completed iteration of any thread is returned.
+ *
+ * @param board Position to search
+ * @param player Player to move (1=Red, 2=Yellow)
+ * @param config Depth, node, thread and time limits
+ * @return Best move from the deepest completed iteration
+ */
+AIResult searchBestMove(const Board& board, int player, const AIConfig& config) {
+    TRACE_SCOPE("search");
+    if (!config.table) {
+        // Searches may start on several threads at once, so only one of them
+        // allocates the default table if nobody configured it beforehand
+        std::call_once(g_tableAllocated, [] {
+            if (!g_table.isAllocated()) g_table.resize(AI_TABLE_MEGABYTES, TT_REPLACE_DEPTH_AGE);
+        });
+    }
+    TranspositionTable& table = config.table ? *config.table : g_table;
+    table.newSearch();
+
+    AIResult initial = {-1, 0, 0, 0};
+    for (int col : MOVE_ORDER) {
+        if (board.canPlay(col)) {
+            initial.column = col;
+            break;
+        }
+    }
+    if (initial.column < 0) return initial;
+
+    // Positions solved before (in this run or an earlier one) need no search;
+    // the cache assumes Player 1 moves on even move counts
+    int remaining = ROWS * COLS - board.moves;
+    bool standardTurn = player == 1 + (board.moves & 1);
+    int cachedColumn, cachedScore;
+    if (standardTurn && probeSolvedCache(board, cachedColumn, cachedScore) && board.canPlay(cachedColumn)) {
+        return {cachedColumn, cachedScore, remaining, 0};
+    }
+
+    std::atomic<std::uint64_t> sharedNodes(0);
+    std::atomic<bool> stop(false);
+    IterationReporter reporter = {&config.onIteration, &sharedNodes, {}, 0};
+    SearchContext base = {&table, 0, config.nodeLimit, &sharedNodes, &stop, config.cancel,
+                          config.onIteration ? &reporter : nullptr, config.timeLimit > 0.0,
+                          SearchClock::now(), false};
+    if (base.hasDeadline) {
+        base.deadline += std::chrono::duration_cast<SearchClock::duration>(
+            std::chrono::duration<double>(config.timeLimit));
+    }
+
+    int maxDepth = std::min(config.maxDepth, remaining);
+    int threads = std::max(1, config.threads);
+    std::vector<AIResult> results(threads, initial);
+    std::vector<SearchContext> contexts(threads, base);
+
+    std::vector<std::thread> helpers;
+    for (int t = 1; t < threads; ++t) {
+        helpers.emplace_back([&, t] {
+            TRACE_THREAD_NAME("search_helper");
+            iterate(contexts[t], board, player, maxDepth, 1 + (t & 1), t, results[t]);
+        });
+    }
+    iterate(contexts[0], board, player, maxDepth, 1, 0, results[0]);
+
+    // The main thread decides when the search is over
+    stop.store(true, std::memory_order_relaxed);
+    for (std::thread& helper : helpers) helper.join();
+
+    AIResult best = results[0];
+    for (int t = 0; t < threads; ++t) {
+        sharedNodes.fetch_add(contexts[t].nodes, std::memory_order_relaxed);
+        if (results[t].depth > best.depth) best = results[t];
+    }
+    best.nodes = sharedNodes.load(std::memory_order_relaxed);
+
+    // A forced win or loss, or a search that reached the end of the game, is exact
+    if (standardTurn && (std::abs(best.score) >= AI_WIN_SCORE - ROWS * COLS || best.depth >= remaining)) {
+        storeSolvedPosition(board, best.column, best.score);
+    }
+    return best;
+}
+
+/**
+ * @brief Pick a column for the computer player within one frame
+ *        The opening book (if open) answers first; otherwise a Lazy SMP
+ *        search runs on every core for AI_MOVE_TIME seconds.
+ * @param board Current position
+ * @param player Player to move (1=Red, 2=Yellow)
+ * @return Column index, or -1 if the board is full
+ */
+int chooseAIMove(const Board& board, int player) {
+    int bookColumn = probeBookMove(board, player);
+    if (bookColumn >= 0) return bookColumn;
+    int threads = hardwareThreads();
+    AIConfig config = {AI_MAX_DEPTH, AI_NODE_LIMIT * threads, threads, AI_MOVE_TIME};
+    return searchBestMove(board, player, config).column;
+}
+
+/**
+ * @brief Look the position up in the opening book (if one is open)
+ * @return Book column, or -1 if the book has no playable move for it
+ */
+int probeBookMove(const Board& board, int player) {
+    // The book assumes Player 1 moves on even move counts
+    int bookColumn, bookScore;
+    if (player == 1 + (board.moves & 1) && probeOpeningBook(board, bookColumn, bookScore) &&
+        board.canPlay(bookColumn)) {
+        return bookColumn;
+    }
+    return -1;
+}
+
+/**
+ * @brief Best move the shared table remembers for a position, without searching
+ *        Used to guess the opponent's reply before pondering on it.
+ * @return Column, or -1 if the position is not in the table
+ */
+int predictMove(const Board& board, int player) {
+    TTHit hit;
+    if (!g_table.isAllocated() || !g_table.probe(positionKey(board.pieces[player - 1], board.occupied()), hit)) {
+        return -1;
+    }
+    return board.canPlay(hit.bestMove) ? hit.bestMove : -1;
+}
+
+/**
+ * @brief Allocate (on first use, at the default size) and wipe the transposition table
+ *        Not safe while a search is running; call it before starting searches.
+ */
+void clearAITable() {
+    if (!g_table.isAllocated()) {
+        g_table.resize(AI_TABLE_MEGABYTES, TT_REPLACE_DEPTH_AGE);
+    } else {
+        g_table.clear();
+    }
+}
+
+/**
+ * @brief Resize the shared transposition table and choose its replacement policy
+ *        Not safe while a search is running; call it before starting searches.
+ * @return false if the allocation failed
+ */
+bool configureAITable(std::size_t megabytes, TTReplacement policy) {
+    return g_table.resize(megabytes, policy);
+}
+
+/**
+ * @brief Read-only access to the shared table (size and huge-page status)
+ */
+const TranspositionTable& getAITable() {
+    return g_table;
+}
@@ -0,0 +1,50 @@
+#ifndef AI_H
+#define AI_H
+
+#include "board.h"
+#include "transposition_table.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+// AI search limits (tuned so one move fits inside a 60 FPS frame)
+constexpr int AI_MAX_DEPTH = 16;                 // Deepest iteration of the search
+constexpr std::uint64_t AI_NODE_LIMIT = 150000;  // Nodes per move before the search stops
+constexpr double AI_MOVE_TIME = 0.012;           // Wall-clock budget per GUI move (seconds)
+constexpr std::size_t AI_TABLE_MEGABYTES = 16;   // Shared transposition table size
+constexpr int AI_WIN_SCORE = 100000;             // Base score of a forced win
+
+// Outcome of a search
+struct AIResult {
+    int column;           // Best column found (-1 if no legal move)
+    int score;            // Score from the mover's point of view
+    int depth;            // Deepest fully completed iteration
+    std::uint64_t nodes;  // Nodes visited by all threads
+};
+
+// Progress callback: receives the best move of each deeper completed
+// iteration, from whichever search thread finished it (calls never overlap)
+using AIProgress = std::function<void(const AIResult&)>;
+
+// Search limits for a single move
+struct AIConfig {
+    int maxDepth;
+    std::uint64_t nodeLimit;  // Total over all search threads
+    int threads = 1;          // Lazy SMP threads sharing the transposition table
+    double timeLimit = 0.0;   // Seconds, 0 = no time limit
+    const std::atomic<bool>* cancel = nullptr; // Set from another thread to stop the search early
+    AIProgress onIteration;   // Optional: called as each deeper iteration completes
+    TranspositionTable* table = nullptr; // Caller's own table, nullptr = the shared one
+};
+
+// AI functions
+AIResult searchBestMove(const Board& board, int player, const AIConfig& config);
+int chooseAIMove(const Board& board, int player);
+int probeBookMove(const Board& board, int player);
+int predictMove(const Board& board, int player);
+void clearAITable();
+bool configureAITable(std::size_t megabytes, TTReplacement policy);
+const TranspositionTable& getAITable();
+
+#endif // AI_H
@@ -0,0 +1,195 @@
+#include "analysis.h"
+#include "ai.h"
+#include "mailbox.h"
+#include "trace.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+// Position handed to the worker
+struct AnalysisRequest {
+    Board board;
+};
+
+LatestMailbox<AnalysisRequest> g_requests; // Main thread -> worker
+LatestMailbox<AnalysisResult> g_results;   // Worker -> main thread
+
+std::atomic<bool> g_cancel(false);          // Aborts the search in progress
+std::atomic<std::uint64_t> g_requested(0);  // Serial of the newest request
+std::atomic<std::uint64_t> g_finished(0);   // Serial of the newest request the worker finished or abandoned
+std::atomic<bool> g_stopping(false);
+
+// Only used to sleep while there is nothing to analyse; results never wait on it
+std::mutex g_wakeLock;
+std::condition_variable g_wake;
+std::thread g_worker;
+
+/**
+ * @brief Classify the search score of one column
+ * @param score Score from the mover's point of view after playing the column
+ * @param moves Plies already played in the analysed position
+ */
+ColumnAnalysis classify(int score, int moves, bool searchedToEnd) {
+    constexpr int PROVEN = AI_WIN_SCORE - ROWS * COLS;
+    if (score >= PROVEN) return {COLUMN_WIN, score, AI_WIN_SCORE - score - moves};
+    if (score <= -PROVEN) return {COLUMN_LOSS, score, AI_WIN_SCORE + score - moves};
+    return {searchedToEnd ? COLUMN_DRAW : COLUMN_SCORED, score, 0};
+}
+
+/**
+ * @brief Post a copy of the result for the main thread
+ */
+void publishResult(const AnalysisResult& result) {
+    g_results.draft() = result;
+    g_results.publish();
+}
+
+/**
+ * @brief Lowest depth reached below the playable columns (0 until each has one)
+ */
+int shallowestDepth(const Board& board, const int* depths) {
+    int shallowest = ROWS * COLS;
+    for (int col = 0; col < COLS; ++col) {
+        if (board.canPlay(col)) shallowest = std::min(shallowest, depths[col]);
+    }
+    return shallowest;
+}
+
+/**
+ * @brief Analyse one position until every column is proven, out of nodes or cancelled
+ *
+ * Each round gives every unproven column one iterative-deepening search,
+ * centre columns first, and posts each deeper iteration as it completes.
+ * The first round is cheap so every column shows a score quickly; later
+ * rounds get four times the nodes and start from the table the earlier
+ * ones filled, until ANALYSIS_NODE_LIMIT.
+ */
+void analysePosition(const AnalysisRequest& request) {
+    TRACE_SCOPE("analysis");
+    const Board& board = request.board;
+    int player = 1 + (board.moves & 1);
+
+    AnalysisResult result = {};
+    result.position = board.key();
+    result.player = player;
+    int depths[COLS] = {}; // Plies searched below each column, counting the column's own move
+    for (int col = 0; col < COLS; ++col) {
+        result.columns[col] = {board.canPlay(col) ? COLUMN_PENDING : COLUMN_FULL, 0, 0};
+    }
+
+    for (std::uint64_t nodes = ANALYSIS_FIRST_NODES; ; nodes = std::min(nodes * 4, ANALYSIS_NODE_LIMIT)) {
+        TRACE_SCOPE("analysis_round");
+        for (int i = 0; i < COLS; ++i) {
+            int col = COLS / 2 + ((i & 1) ? -(i + 1) / 2 : i / 2);
+            if (result.columns[col].verdict == COLUMN_FULL || result.columns[col].verdict > COLUMN_SCORED) continue;
+            Board child = board;
+            child.drop(col, player);
+            int remaining = ROWS * COLS - child.moves;
+
+            if (child.hasWon(player)) {
+                result.columns[col] = {COLUMN_WIN, AI_WIN_SCORE - child.moves, 1};
+                depths[col] = remaining + 1;
+            } else if (child.isFull()) {
+                result.columns[col] = {COLUMN_DRAW, 0, 0};
+                depths[col] = remaining + 1;
+            } else {
+                // Only an iteration deeper than any seen before replaces the column
+                auto record = [&](const AIResult& reply) {
+                    if (reply.depth + 1 <= depths[col]) return false;
+                    result.columns[col] = classify(-reply.score, board.moves, reply.depth >= remaining);
+                    depths[col] = reply.depth + 1;
+                    result.depth = shallowestDepth(board, depths);
+                    return true;
+                };
+                AIConfig config = {remaining, nodes};
+                config.cancel = &g_cancel;
+                config.onIteration = [&](const AIResult& reply) {
+                    if (record(reply)) publishResult(result);
+                };
+                AIResult reply = searchBestMove(child, 3 - player, config);
+                if (g_cancel.load(std::memory_order_relaxed)) return; // A newer position is waiting
+                // Answers that needed no iteration (solved cache) arrive only here
+                if (reply.column >= 0) record(reply);
+                if (result.columns[col].verdict == COLUMN_PENDING) {
+                    result.columns[col] = classify(0, board.moves, false); // Out of nodes before depth 1
+                }
+            }
+            result.depth = shallowestDepth(board, depths);
+            publishResult(result);
+        }
+
+        bool proven = true;
+        for (int col = 0; col < COLS; ++col) proven = proven && result.columns[col].verdict != COLUMN_SCORED;
+        if (proven || nodes == ANALYSIS_NODE_LIMIT) break;
+    }
+
+    result.complete = true;
+    publishResult(result);
+}
+
+void runWorker() {
+    TRACE_THREAD_NAME("analysis");
+    AnalysisRequest request = {};
+    for (;;) {
+        std::uint64_t serial;
+        {
+            // Claiming the serial and clearing the cancel flag happen together,
+            // so any later request is guaranteed to cancel this analysis
+            std::unique_lock<std::mutex> guard(g_wakeLock);
+            g_wake.wait(guard, [&] {
+                return g_stopping.load() || g_requested.load() != g_finished.load();
+            });
+            if (g_stopping.load()) return;
+            serial = g_requested.load();
+            g_cancel.store(false, std::memory_order_relaxed);
+        }
+
+        // The mailbox holds the newest position (possibly newer than serial);
+        // if it was already taken, the one kept from last time is still the newest
+        g_requests.take(request);
+        analysePosition(request);
+        g_finished.store(serial);
+    }
+}
+
+} // namespace
+
+void requestAnalysis(const Board& board) {
+    if (!g_worker.joinable()) {
+        g_stopping.store(false);
+        g_worker = std::thread(runWorker);
+    }
+
+    g_requests.draft() = {board};
+    g_requests.publish();
+    {
+        // Held only for two stores, to order them with the worker's claim
+        std::lock_guard<std::mutex> guard(g_wakeLock);
+        g_requested.store(g_requested.load() + 1);
+        g_cancel.store(true, std::memory_order_relaxed);
+    }
+    g_wake.notify_one();
+}
+
+bool pollAnalysis(AnalysisResult& out) {
+    return g_results.take(out);
+}
+
+bool isAnalysisRunning() {
+    return g_finished.load() != g_requested.load();
+}
+
+void stopAnalysis() {
+    if (!g_worker.joinable()) return;
+    g_cancel.store(true, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> guard(g_wakeLock);
+        g_stopping.store(true);
+    }
+    g_wake.notify_one();
+    g_worker.join();
+}
@@ -0,0 +1,63 @@
+#ifndef ANALYSIS_H
+#define ANALYSIS_H
+
+#include "board.h"
+#include <cstdint>
+
+// Background analysis of every column of a position. A worker thread scores
+// each playable column with iterative-deepening searches of growing node
+// budgets and posts a snapshot after every deeper completed iteration; a
+// new request cancels the running search at once.
+// No SFML here, so the analysis also works from the headless tools.
+
+constexpr std::uint64_t ANALYSIS_FIRST_NODES = 250000;  // Per column in the first round
+constexpr std::uint64_t ANALYSIS_NODE_LIMIT = 20000000; // Per column in the last round; cancellation usually ends it first
+
+// What is known about playing a column
+enum ColumnVerdict : std::uint8_t {
+    COLUMN_FULL,    // Not playable
+    COLUMN_PENDING, // Not searched yet
+    COLUMN_SCORED,  // Heuristic score only
+    COLUMN_WIN,     // Forced win for the mover
+    COLUMN_LOSS,    // Forced loss for the mover
+    COLUMN_DRAW     // Searched to the end of the game
+};
+
+struct ColumnAnalysis {
+    ColumnVerdict verdict;
+    int score;  // Search score from the mover's point of view
+    int plies;  // Win/loss: plies from the analysed position to the end of the game
+};
+
+struct AnalysisResult {
+    std::uint64_t position;  // Board::key() of the analysed position
+    int player;              // Mover (1=Red, 2=Yellow)
+    int depth;               // Shallowest completed depth below the playable columns (0 = some still pending)
+    bool complete;           // Every column proven or out of nodes; the worker has gone idle
+    ColumnAnalysis columns[COLS];
+};
+
+/**
+ * @brief Analyse a new position, cancelling the one in progress
+ *        Starts the worker thread on first use. Never blocks on the search.
+ * @param board Position to analyse (copied); the mover is 1 + (moves & 1)
+ */
+void requestAnalysis(const Board& board);
+
+/**
+ * @brief Fetch the newest result if the worker posted one since the last call
+ * @return false if there is nothing new
+ */
+bool pollAnalysis(AnalysisResult& out);
+
+/**
+ * @brief Whether the worker is still refining the latest request
+ */
+bool isAnalysisRunning();
+
+/**
+ * @brief Cancel any search and join the worker thread
+ */
+void stopAnalysis();
+
+#endif // ANALYSIS_H
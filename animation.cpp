@@ -1,97 +1,196 @@
 #include "animation.h"
 #include <cmath>
 
-// Define the global animation state
-AnimationState g_animation = {false, 0, 0, 0, 0.0f, 0.0f};
+namespace {
+
+// Every animation is drawn as one filled circle (triangle fan)
+constexpr int PIECE_SEGMENTS = 32;
+constexpr int PIECE_VERTICES = PIECE_SEGMENTS * 3;
+
+// Vertices of every active animation, rebuilt each frame and drawn with one call
+sf::Vertex g_animationVertices[MAX_ANIMATIONS * PIECE_VERTICES];
+
+/**
+ * @brief Claim a free slot and fill in the fields shared by every kind
+ * @return Slot index, or -1 if the pool is full
+ */
+int allocateAnimation(AnimationKind kind, int row, int col, int player, float timeScale) {
+    if (g_animations.count >= MAX_ANIMATIONS) return -1;
+    int i = g_animations.count++;
+    g_animations.kind[i] = kind;
+    g_animations.column[i] = static_cast<std::uint8_t>(col);
+    g_animations.row[i] = static_cast<std::uint8_t>(row);
+    g_animations.player[i] = static_cast<std::uint8_t>(player);
+    g_animations.timeScale[i] = timeScale;
+    g_animations.currentY[i] = 0.0f;
+    g_animations.previousY[i] = 0.0f;
+    g_animations.targetY[i] = 0.0f;
+    g_animations.velocity[i] = 0.0f;
+    g_animations.elapsed[i] = 0.0f;
+    return i;
+}
+
+/**
+ * @brief Free a slot by moving the last active animation into it
+ */
+void removeAnimation(int i) {
+    int last = --g_animations.count;
+    if (i == last) return;
+    g_animations.kind[i] = g_animations.kind[last];
+    g_animations.column[i] = g_animations.column[last];
+    g_animations.row[i] = g_animations.row[last];
+    g_animations.player[i] = g_animations.player[last];
+    g_animations.timeScale[i] = g_animations.timeScale[last];
+    g_animations.currentY[i] = g_animations.currentY[last];
+    g_animations.previousY[i] = g_animations.previousY[last];
+    g_animations.targetY[i] = g_animations.targetY[last];
+    g_animations.velocity[i] = g_animations.velocity[last];
+    g_animations.elapsed[i] = g_animations.elapsed[last];
+}
 
 /**
- * @brief Initialize and start a fall animation for a piece
+ * @brief Write one filled circle into the vertex buffer
+ */
+void appendCircle(int& used, sf::Vector2f center, sf::Color color) {
+    // Unit circle, computed on first use
+    static sf::Vector2f unit[PIECE_SEGMENTS + 1];
+    static bool unitReady = false;
+    if (!unitReady) {
+        for (int s = 0; s <= PIECE_SEGMENTS; ++s) {
+            float angle = 2.0f * 3.14159265f * s / PIECE_SEGMENTS;
+            unit[s] = sf::Vector2f(std::cos(angle), std::sin(angle));
+        }
+        unitReady = true;
+    }
+
+    sf::Vertex* v = g_animationVertices + used;
+    for (int s = 0; s < PIECE_SEGMENTS; ++s) {
+        v[s * 3 + 0].position = center;
+        v[s * 3 + 1].position = center + unit[s] * PIECE_RADIUS;
+        v[s * 3 + 2].position = center + unit[s + 1] * PIECE_RADIUS;
+    }
+    for (int k = 0; k < PIECE_VERTICES; ++k) v[k].color = color;
+    used += PIECE_VERTICES;
+}
+
+} // namespace
+
+// Define the global animation pool
+AnimationPool g_animations = {};
+
+/**
+ * @brief Start a piece falling into a column
  * @param col Column where piece is dropping
  * @param targetRow Final row position for the piece
  * @param player Player number (1=Red, 2=Yellow)
+ * @param timeScale Playback speed (e.g. 10 for fast replays)
+ * @return Slot index, or -1 if the pool is full
+ */
+int startDropAnimation(int col, int targetRow, int player, float timeScale) {
+    int i = allocateAnimation(ANIMATION_DROP, targetRow, col, player, timeScale);
+    if (i >= 0) {
+        // Starts at the top of the board (currentY = 0) and falls to the slot centre
+        g_animations.targetY[i] = targetRow * CELL_SIZE + CELL_SIZE / 2.0f;
+    }
+    return i;
+}
+
+/**
+ * @brief Start a piece on the board flashing (used for the winning line)
+ * @return Slot index, or -1 if the pool is full
  */
-void initAnimation(int col, int targetRow, int player) {
-    g_animation.isActive = true;
-    g_animation.column = col;
-    g_animation.targetRow = targetRow;
-    g_animation.player = player;
-    g_animation.currentY = 0.0f; // Start at top of board
-    g_animation.velocity = 0.0f;  // Start with zero velocity
+int startFlashAnimation(int row, int col, int player, float timeScale) {
+    return allocateAnimation(ANIMATION_FLASH, row, col, player, timeScale);
 }
 
 /**
- * @brief Update animation state based on elapsed time
- * @param deltaTime Time elapsed since last frame (in seconds)
+ * @brief Advance every active animation by one step and drop finished ones
+ * @param deltaTime Length of one simulation step (in seconds)
  */
-void updateAnimation(float deltaTime) {
-    if (!g_animation.isActive) return;
-
-    // Calculate target Y position
-    float targetY = g_animation.targetRow * CELL_SIZE_ANIM + CELL_SIZE_ANIM / 2.0f;
-    
-    // Apply gravity to velocity
-    g_animation.velocity += GRAVITY * deltaTime;
-    
-    // Update position
-    g_animation.currentY += g_animation.velocity * deltaTime;
-    
-    // Check if we've reached or passed the target
-    if (g_animation.currentY >= targetY) {
-        g_animation.currentY = targetY;
-        g_animation.isActive = false; // Animation complete
+void updateAnimations(float deltaTime) {
+    for (int i = 0; i < g_animations.count;) {
+        float dt = deltaTime * g_animations.timeScale[i];
+        bool finished;
+        if (g_animations.kind[i] == ANIMATION_DROP) {
+            g_animations.previousY[i] = g_animations.currentY[i];
+            g_animations.velocity[i] += GRAVITY * dt;
+            g_animations.currentY[i] += g_animations.velocity[i] * dt;
+            finished = g_animations.currentY[i] >= g_animations.targetY[i];
+        } else {
+            g_animations.elapsed[i] += dt;
+            finished = g_animations.elapsed[i] >= FLASH_DURATION;
+        }
+
+        if (finished) {
+            removeAnimation(i); // The last animation moves into slot i, so do not advance
+        } else {
+            ++i;
+        }
     }
 }
 
 /**
- * @brief Draw the falling piece at its current animated position
+ * @brief Draw every active animation with a single batched draw call
  * @param window SFML render window to draw on
+ * @param interpolation Fraction of a simulation step elapsed since the last one (0..1)
  */
-void drawFallingPiece(sf::RenderWindow& window) {
-    if (!g_animation.isActive) return;
-
-    float centerX = g_animation.column * CELL_SIZE_ANIM + CELL_SIZE_ANIM / 2.0f;
-    
-    sf::CircleShape piece(PIECE_RADIUS_ANIM);
-    piece.setOrigin(sf::Vector2f(PIECE_RADIUS_ANIM, PIECE_RADIUS_ANIM));
-    piece.setPosition(sf::Vector2f(centerX, g_animation.currentY));
-    
-    // Set color based on player
-    if (g_animation.player == 1) {
-        piece.setFillColor(sf::Color::Red);
-    } else {
-        piece.setFillColor(sf::Color::Yellow);
+void drawAnimations(sf::RenderWindow& window, float interpolation) {
+    int used = 0;
+    for (int i = 0; i < g_animations.count; ++i) {
+        float centerX = g_animations.column[i] * CELL_SIZE + CELL_SIZE / 2.0f;
+        if (g_animations.kind[i] == ANIMATION_DROP) {
+            float centerY = g_animations.previousY[i] +
+                            (g_animations.currentY[i] - g_animations.previousY[i]) * interpolation;
+            sf::Color color = (g_animations.player[i] == 1) ? sf::Color::Red : sf::Color::Yellow;
+            appendCircle(used, sf::Vector2f(centerX, centerY), color);
+        } else {
+            // White overlay whose opacity peaks FLASH_PULSES times
+            float pulse = std::sin(3.14159265f * FLASH_PULSES * g_animations.elapsed[i] / FLASH_DURATION);
+            float centerY = g_animations.row[i] * CELL_SIZE + CELL_SIZE / 2.0f;
+            appendCircle(used, sf::Vector2f(centerX, centerY),
+                         sf::Color(255, 255, 255, static_cast<std::uint8_t>(200.0f * pulse * pulse)));
+        }
+    }
+    if (used > 0) {
+        window.draw(g_animationVertices, used, sf::PrimitiveType::Triangles);
     }
-    
-    window.draw(piece);
 }
 
 /**
- * @brief Check if animation is currently active
- * @return true if animation is running, false otherwise
+ * @brief Check if any animation is running
  */
 bool isAnimationActive() {
-    return g_animation.isActive;
+    return g_animations.count > 0;
 }
 
 /**
- * @brief Reset animation state to inactive
+ * @brief Number of pieces still falling
  */
-void resetAnimation() {
-    g_animation.isActive = false;
-    g_animation.column = 0;
-    g_animation.targetRow = 0;
-    g_animation.player = 0;
-    g_animation.currentY = 0.0f;
-    g_animation.velocity = 0.0f;
+int getActiveDropCount() {
+    int drops = 0;
+    for (int i = 0; i < g_animations.count; ++i) {
+        drops += g_animations.kind[i] == ANIMATION_DROP;
+    }
+    return drops;
 }
 
 /**
- * @brief Get the target row for the current animation
- * @return Target row index, or -1 if no animation active
+ * @brief Board cells whose pieces are still falling, in the bitboard layout
+ *        (the board hides them until they land)
  */
-int getAnimationTargetRow() {
-    if (g_animation.isActive) {
-        return g_animation.targetRow;
+std::uint64_t getFallingCells() {
+    std::uint64_t cells = 0;
+    for (int i = 0; i < g_animations.count; ++i) {
+        if (g_animations.kind[i] == ANIMATION_DROP) {
+            cells |= std::uint64_t(1) << (g_animations.column[i] * COLUMN_BITS + (ROWS - 1 - g_animations.row[i]));
+        }
     }
-    return -1;
+    return cells;
+}
+
+/**
+ * @brief Stop every animation
+ */
+void resetAnimations() {
+    g_animations.count = 0;
 }
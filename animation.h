@@ -2,31 +2,49 @@
 #define ANIMATION_H
 
 #include <SFML/Graphics.hpp>
+#include "layout.h"
+#include <cstdint>
 
 // Animation constants
 constexpr float GRAVITY = 1600.0f;       // Pixels per second squared (doubled for faster animation)
-constexpr float CELL_SIZE_ANIM = 100.0f; // Match main game cell size
-constexpr float PIECE_RADIUS_ANIM = 40.0f;
+constexpr int MAX_ANIMATIONS = 64;       // Pool capacity: a full board of drops plus a win line
+constexpr float FLASH_DURATION = 1.5f;   // Seconds a winning piece keeps flashing
+constexpr int FLASH_PULSES = 3;          // Brightness peaks during one flash
 
-// Animation state structure
-struct AnimationState {
-    bool isActive;
-    int column;
-    int targetRow;
-    int player;          // 1 for Red, 2 for Yellow
-    float currentY;      // Current Y position
-    float velocity;      // Current velocity (pixels/second)
+// Kinds of animation the pool runs
+enum AnimationKind : std::uint8_t {
+    ANIMATION_DROP,  // Piece falling into its slot
+    ANIMATION_FLASH  // Winning piece pulsing after the game ends
 };
 
-// Global animation state
-extern AnimationState g_animation;
+// Fixed-capacity animation pool, stored as one array per field so the
+// update loop walks contiguous floats. Active animations are packed into
+// the first `count` entries; finished ones are swapped out with the last.
+struct AnimationPool {
+    int count;
+    AnimationKind kind[MAX_ANIMATIONS];
+    std::uint8_t column[MAX_ANIMATIONS];
+    std::uint8_t row[MAX_ANIMATIONS];        // Target (drop) or flashing (flash) screen row
+    std::uint8_t player[MAX_ANIMATIONS];     // 1 for Red, 2 for Yellow
+    float timeScale[MAX_ANIMATIONS];         // Playback speed (1 = real time, 10 = fast replay)
+    float currentY[MAX_ANIMATIONS];          // Drop: current Y position
+    float previousY[MAX_ANIMATIONS];         // Drop: Y one simulation step earlier (for interpolation)
+    float targetY[MAX_ANIMATIONS];           // Drop: Y of the slot centre
+    float velocity[MAX_ANIMATIONS];          // Drop: pixels/second
+    float elapsed[MAX_ANIMATIONS];           // Flash: seconds since it started
+};
+
+// Global animation pool
+extern AnimationPool g_animations;
 
 // Animation functions
-void initAnimation(int col, int targetRow, int player);
-void updateAnimation(float deltaTime);
-void drawFallingPiece(sf::RenderWindow& window);
+int startDropAnimation(int col, int targetRow, int player, float timeScale = 1.0f);
+int startFlashAnimation(int row, int col, int player, float timeScale = 1.0f);
+void updateAnimations(float deltaTime);
+void drawAnimations(sf::RenderWindow& window, float interpolation);
 bool isAnimationActive();
-void resetAnimation();
-int getAnimationTargetRow();
+int getActiveDropCount();
+std::uint64_t getFallingCells();
+void resetAnimations();
 
 #endif // ANIMATION_H
@@ -0,0 +1,67 @@
+#include "anytime_search.h"
+#include "ai.h"
+#include "trace.h"
+#include <chrono>
+
+namespace {
+
+using SearchClock = std::chrono::steady_clock;
+
+std::uint64_t packMove(const AnytimeMove& move) {
+    return static_cast<std::uint64_t>(move.column + 1) | (static_cast<std::uint64_t>(move.depth) << 8) |
+           (static_cast<std::uint64_t>(static_cast<std::uint32_t>(move.score)) << 32);
+}
+
+AnytimeMove unpackMove(std::uint64_t packed) {
+    return {static_cast<int>(packed & 0xFF) - 1, static_cast<std::int32_t>(packed >> 32),
+            static_cast<int>((packed >> 8) & 0xFF)};
+}
+
+} // namespace
+
+AnytimeSearch::~AnytimeSearch() {
+    stop();
+}
+
+void AnytimeSearch::start(const Board& position, int player, double seconds, int threads) {
+    stop();
+    board = position;
+    startTime = SearchClock::now();
+    cancel.store(false, std::memory_order_relaxed);
+    finished.store(false, std::memory_order_relaxed);
+    packedBest.store(packMove({-1, 0, 0}), std::memory_order_relaxed);
+    worker = std::thread([this, player, seconds, threads] { run(player, seconds, threads); });
+}
+
+AnytimeMove AnytimeSearch::stop() {
+    if (worker.joinable()) {
+        cancel.store(true, std::memory_order_relaxed);
+        worker.join();
+    }
+    return best();
+}
+
+AnytimeMove AnytimeSearch::best() const {
+    return unpackMove(packedBest.load(std::memory_order_acquire));
+}
+
+void AnytimeSearch::publish(const AnytimeMove& move) {
+    packedBest.store(packMove(move), std::memory_order_release);
+}
+
+/**
+ * @brief One iterative-deepening search to the end of the game; every
+ *        deeper iteration any thread completes is published as it finishes
+ */
+void AnytimeSearch::run(int player, double seconds, int threads) {
+    TRACE_THREAD_NAME("anytime_search");
+    TRACE_SCOPE("anytime_search");
+    AIConfig config = {ROWS * COLS - board.moves, UINT64_MAX, threads, seconds};
+    config.cancel = &cancel;
+    config.onIteration = [this](const AIResult& result) { publish({result.column, result.score, result.depth}); };
+
+    // The result also covers answers that need no iteration (solved cache)
+    AIResult result = searchBestMove(board, player, config);
+    if (result.column >= 0 && result.depth > best().depth) publish({result.column, result.score, result.depth});
+    finished.store(true, std::memory_order_release);
+}
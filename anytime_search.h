@@ -0,0 +1,93 @@
+#ifndef ANYTIME_SEARCH_H
+#define ANYTIME_SEARCH_H
+
+#include "board.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+// Best move known so far by an anytime search
+struct AnytimeMove {
+    int column;  // -1 until the first iteration completes
+    int score;   // From the mover's point of view
+    int depth;   // Deepest completed iteration
+};
+
+/**
+ * @brief Iterative deepening on a worker thread, with a move ready at any time
+ *
+ * Each completed depth publishes its best move through one atomic word, so
+ * the caller can read it every frame without waiting, and stop() returns
+ * within a few microseconds by cancelling the search in flight. The search
+ * ends on its own when the time runs out, the result is proven, or every
+ * remaining ply has been searched.
+ */
+class AnytimeSearch {
+public:
+    AnytimeSearch() = default;
+    ~AnytimeSearch();
+    AnytimeSearch(const AnytimeSearch&) = delete;
+    AnytimeSearch& operator=(const AnytimeSearch&) = delete;
+
+    /**
+     * @brief Start searching a position (stops any search in progress)
+     * @param board Position to search (copied)
+     * @param player Player to move (1=Red, 2=Yellow)
+     * @param seconds Wall-clock budget, 0 = until stop() is called
+     * @param threads Lazy SMP threads
+     */
+    void start(const Board& board, int player, double seconds, int threads);
+
+    /**
+     * @brief Cancel the search and wait for the worker to exit
+     * @return The best move found
+     */
+    AnytimeMove stop();
+
+    /**
+     * @brief Best move from the deepest completed iteration (never blocks)
+     */
+    AnytimeMove best() const;
+
+    /**
+     * @brief Whether a search was started and not yet stopped
+     */
+    bool isActive() const {
+        return worker.joinable();
+    }
+
+    /**
+     * @brief Whether the worker ended on its own (time up, proven or searched to the end)
+     */
+    bool isFinished() const {
+        return finished.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Seconds since start() (wall clock)
+     */
+    double elapsedSeconds() const {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    }
+
+    /**
+     * @brief Position being searched (valid while isActive())
+     */
+    const Board& getBoard() const {
+        return board;
+    }
+
+private:
+    void run(int player, double seconds, int threads);
+    void publish(const AnytimeMove& move);
+
+    Board board = {};
+    std::chrono::steady_clock::time_point startTime;
+    std::thread worker;
+    std::atomic<bool> cancel{false};
+    std::atomic<bool> finished{false};
+    std::atomic<std::uint64_t> packedBest{0}; // column + 1 | depth << 8 | score << 32
+};
+
+#endif // ANYTIME_SEARCH_H
@@ -0,0 +1,150 @@
+#include "asset_loader.h"
+#include "trace.h"
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+namespace {
+
+const char* const IMAGE_PATHS[ATLAS_IMAGE_COUNT] = {
+    "assets/ui_sprites.jpg",
+    "assets/draw_sprite.png",
+    "assets/start_screen.png"
+};
+
+// Bundled font first, then the macOS system fonts
+const char* const FONT_PATHS[] = {
+    "assets/Arial.ttf",
+    "/System/Library/Fonts/Helvetica.ttc",
+    "/System/Library/Fonts/Supplemental/Arial.ttf"
+};
+
+constexpr int LOADING_STEPS = ATLAS_IMAGE_COUNT + 2; // Images, font, atlas packing
+
+// Written by the loader thread, read by the main thread only after g_loaderFinished
+sf::Image g_atlasImage;
+bool g_imageLoaded[ATLAS_IMAGE_COUNT] = {false, false, false};
+AtlasRegion g_regions[ATLAS_IMAGE_COUNT];
+sf::Font g_font;
+bool g_fontLoaded = false;
+
+std::thread g_loaderThread;
+std::atomic<int> g_stepsDone(0);
+std::atomic<bool> g_loaderFinished(false);
+
+// Main-thread state
+std::unique_ptr<sf::Texture> g_atlas = nullptr;
+bool g_assetsReady = false;
+
+/**
+ * @brief Background thread: decode every image, open the font, pack the atlas
+ */
+void loadAssets() {
+    TRACE_THREAD_NAME("asset_loader");
+    TRACE_SCOPE("load_assets");
+    sf::Image images[ATLAS_IMAGE_COUNT];
+    for (int i = 0; i < ATLAS_IMAGE_COUNT; ++i) {
+        TRACE_SCOPE("decode_image");
+        g_imageLoaded[i] = images[i].loadFromFile(IMAGE_PATHS[i]);
+        if (!g_imageLoaded[i] && i != ATLAS_UI) {
+            std::cerr << "--- WARNING ---" << std::endl;
+            std::cerr << "Failed to load " << IMAGE_PATHS[i] << "; the game will use its fallback." << std::endl;
+        }
+        g_stepsDone.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    {
+        TRACE_SCOPE("open_font");
+        for (const char* path : FONT_PATHS) {
+            if (g_font.openFromFile(path)) {
+                g_fontLoaded = true;
+                break;
+            }
+        }
+    }
+    g_stepsDone.fetch_add(1, std::memory_order_relaxed);
+
+    // Layout: the UI sheet (tall) forms the left column and the other
+    // images (wide) stack in a column to its right
+    sf::Vector2u sizes[ATLAS_IMAGE_COUNT];
+    for (int i = 0; i < ATLAS_IMAGE_COUNT; ++i) {
+        sizes[i] = g_imageLoaded[i] ? images[i].getSize() : sf::Vector2u(0, 0);
+    }
+    unsigned columnX = sizes[ATLAS_UI].x;
+    unsigned width = columnX;
+    unsigned height = sizes[ATLAS_UI].y;
+    unsigned y = 0;
+    g_regions[ATLAS_UI].offset = sf::Vector2i(0, 0);
+    for (int i = ATLAS_UI + 1; i < ATLAS_IMAGE_COUNT; ++i) {
+        g_regions[i].offset = sf::Vector2i(static_cast<int>(columnX), static_cast<int>(y));
+        width = std::max(width, columnX + sizes[i].x);
+        y += sizes[i].y;
+    }
+    height = std::max(height, y);
+
+    if (width > 0 && height > 0) {
+        TRACE_SCOPE("pack_atlas");
+        g_atlasImage = sf::Image(sf::Vector2u(width, height), sf::Color::Transparent);
+        for (int i = 0; i < ATLAS_IMAGE_COUNT; ++i) {
+            g_regions[i].size = sf::Vector2i(static_cast<int>(sizes[i].x), static_cast<int>(sizes[i].y));
+            if (g_imageLoaded[i] &&
+                !g_atlasImage.copy(images[i], sf::Vector2u(g_regions[i].offset))) {
+                g_imageLoaded[i] = false;
+            }
+        }
+    }
+    g_stepsDone.fetch_add(1, std::memory_order_relaxed);
+
+    g_loaderFinished.store(true, std::memory_order_release);
+}
+
+} // namespace
+
+void startAssetLoading() {
+    if (g_loaderThread.joinable() || g_assetsReady) return;
+    g_loaderThread = std::thread(loadAssets);
+}
+
+bool updateAssetLoading() {
+    if (g_assetsReady) return true;
+    if (!g_loaderFinished.load(std::memory_order_acquire)) return false;
+    g_loaderThread.join();
+
+    // Texture upload needs the window's GL context, so it happens here
+    TRACE_SCOPE("upload_atlas");
+    g_atlas = std::make_unique<sf::Texture>();
+    if (!g_atlas->loadFromImage(g_atlasImage)) {
+        std::cerr << "--- SPRITE ERROR ---" << std::endl;
+        std::cerr << "Failed to create the sprite atlas texture." << std::endl;
+        std::fill(g_imageLoaded, g_imageLoaded + ATLAS_IMAGE_COUNT, false);
+        g_atlas = nullptr;
+    }
+    g_atlasImage = sf::Image(); // The pixels live on the GPU now
+
+    for (AtlasRegion& region : g_regions) region.texture = g_atlas.get();
+    g_assetsReady = true;
+    return true;
+}
+
+float getAssetLoadingProgress() {
+    return static_cast<float>(g_stepsDone.load(std::memory_order_relaxed)) / LOADING_STEPS;
+}
+
+void shutdownAssetLoading() {
+    if (g_loaderThread.joinable()) g_loaderThread.join();
+}
+
+const AtlasRegion* getAtlasRegion(AtlasImage image) {
+    if (!g_assetsReady || !g_imageLoaded[image]) return nullptr;
+    return &g_regions[image];
+}
+
+const sf::Font& getGameFont() {
+    return g_font;
+}
+
+bool isGameFontLoaded() {
+    return g_fontLoaded;
+}
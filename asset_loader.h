@@ -0,0 +1,75 @@
+#ifndef ASSET_LOADER_H
+#define ASSET_LOADER_H
+
+#include <SFML/Graphics.hpp>
+
+// Images packed into the shared sprite atlas
+enum AtlasImage {
+    ATLAS_UI,    // assets/ui_sprites.jpg (turn indicators, game over, restart)
+    ATLAS_DRAW,  // assets/draw_sprite.png
+    ATLAS_START, // assets/start_screen.png (title and menu buttons)
+    ATLAS_IMAGE_COUNT
+};
+
+/**
+ * @brief Where one source image sits inside the atlas texture
+ */
+struct AtlasRegion {
+    const sf::Texture* texture; // The shared atlas
+    sf::Vector2i offset;        // Top-left corner of the image inside the atlas
+    sf::Vector2i size;          // Size of the source image
+
+    /**
+     * @brief Convert a rectangle given in source-image pixels to atlas pixels
+     */
+    sf::IntRect rect(const sf::IntRect& local) const {
+        return sf::IntRect(local.position + offset, local.size);
+    }
+
+    /**
+     * @brief The whole source image, in atlas pixels
+     */
+    sf::IntRect bounds() const {
+        return sf::IntRect(offset, size);
+    }
+};
+
+/**
+ * @brief Start decoding the sprite images and the font on a background thread
+ */
+void startAssetLoading();
+
+/**
+ * @brief Finish loading once the background thread is done (main thread only)
+ *        Uploads the packed atlas to the GPU on the call that sees the loader finish.
+ * @return true once every asset is ready to use
+ */
+bool updateAssetLoading();
+
+/**
+ * @brief Fraction of the loading steps completed, from 0 to 1
+ */
+float getAssetLoadingProgress();
+
+/**
+ * @brief Wait for the background thread (call before exiting)
+ */
+void shutdownAssetLoading();
+
+/**
+ * @brief Region of an image inside the atlas
+ * @return nullptr if loading has not finished or the image failed to load
+ */
+const AtlasRegion* getAtlasRegion(AtlasImage image);
+
+/**
+ * @brief Font used for all text (valid once loading has finished)
+ */
+const sf::Font& getGameFont();
+
+/**
+ * @brief Check whether any font file could be opened
+ */
+bool isGameFontLoaded();
+
+#endif // ASSET_LOADER_H
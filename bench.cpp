@@ -0,0 +1,255 @@
+// Headless micro-benchmarks for the rules library and the AI search.
+// Build and run with: make bench
+
+#include "ai.h"
+#include "mcts.h"
+#include "parallel.h"
+#include "playout_engine.h"
+#include "rules.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+constexpr int DEFAULT_REPETITIONS = 7;
+constexpr int POSITION_COUNT = 4096;     // Positions sampled for checkWin
+constexpr int GAME_COUNT = 4096;         // Recorded games replayed for the drop benchmark
+constexpr int PLAYOUTS_PER_REP = 200000;
+constexpr int SEARCH_POSITIONS = 16;
+constexpr std::uint64_t SEARCH_NODE_LIMIT = 200000;
+constexpr int TTD_DEPTH = 12;            // Fixed depth for the Lazy SMP time-to-depth runs
+constexpr int TTD_POSITIONS = 8;
+constexpr std::uint64_t MCTS_PLAYOUTS_PER_REP = 200000;
+
+using BenchClock = std::chrono::steady_clock;
+
+// Keeps results observable so the optimiser cannot drop the measured work
+volatile std::uint64_t g_sink = 0;
+
+struct Stats {
+    double mean;
+    double stddev;
+    double min;
+    double max;
+};
+
+// A position together with the last move that produced it
+struct Sample {
+    Board board;
+    int lastRow;
+    int lastCol;
+};
+
+// A finished game stored as its move list
+struct Recorded {
+    int moves;
+    std::int8_t cols[ROWS * COLS];
+};
+
+double elapsedNs(BenchClock::time_point start) {
+    return std::chrono::duration<double, std::nano>(BenchClock::now() - start).count();
+}
+
+/**
+ * @brief Run a benchmark body several times and summarise its per-rep values
+ */
+template <typename Fn>
+Stats measure(int repetitions, Fn body) {
+    body(); // Warm-up: caches, branch predictors, AI table allocation
+
+    std::vector<double> values;
+    for (int i = 0; i < repetitions; ++i) values.push_back(body());
+
+    Stats stats = {0.0, 0.0, values[0], values[0]};
+    for (double v : values) {
+        stats.mean += v;
+        stats.min = std::min(stats.min, v);
+        stats.max = std::max(stats.max, v);
+    }
+    stats.mean /= values.size();
+    for (double v : values) stats.stddev += (v - stats.mean) * (v - stats.mean);
+    stats.stddev = std::sqrt(stats.stddev / values.size());
+    return stats;
+}
+
+void printRow(const char* name, const Stats& s, const char* unit) {
+    std::printf("%-18s %14.2f %12.2f (%5.1f%%) %14.2f %14.2f  %s\n",
+                name, s.mean, s.stddev, s.mean > 0 ? 100.0 * s.stddev / s.mean : 0.0,
+                s.min, s.max, unit);
+}
+
+std::vector<Recorded> recordGames(std::uint64_t& rng) {
+    std::vector<Recorded> games(GAME_COUNT);
+    for (Recorded& game : games) {
+        Board board;
+        resetBoard(board);
+        game.moves = 0;
+        int player = 1;
+        while (!checkDraw(board)) {
+            int col = randomLegalColumn(board, rng);
+            int row = dropPiece(board, col, player);
+            game.cols[game.moves++] = static_cast<std::int8_t>(col);
+            if (checkWin(board, row, col)) break;
+            player = (player == 1) ? 2 : 1;
+        }
+    }
+    return games;
+}
+
+std::vector<Sample> samplePositions(const std::vector<Recorded>& games, std::uint64_t& rng) {
+    std::vector<Sample> samples;
+    for (int i = 0; i < POSITION_COUNT; ++i) {
+        const Recorded& game = games[i % games.size()];
+        int stop = 1 + static_cast<int>(nextRandom(rng) % game.moves);
+        Sample s;
+        resetBoard(s.board);
+        int player = 1;
+        for (int m = 0; m < stop; ++m) {
+            s.lastCol = game.cols[m];
+            s.lastRow = dropPiece(s.board, s.lastCol, player);
+            player = (player == 1) ? 2 : 1;
+        }
+        samples.push_back(s);
+    }
+    return samples;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int repetitions = (argc > 1) ? std::atoi(argv[1]) : DEFAULT_REPETITIONS;
+    if (repetitions < 1) repetitions = DEFAULT_REPETITIONS;
+
+    std::uint64_t rng = 0x9E3779B97F4A7C15ull;
+    std::vector<Recorded> games = recordGames(rng);
+    std::vector<Sample> samples = samplePositions(games, rng);
+
+    std::printf("Connect 4 benchmarks (%d repetitions after one warm-up)\n\n", repetitions);
+    std::printf("%-18s %14s %22s %14s %14s\n", "benchmark", "mean", "stddev", "min", "max");
+
+    // ns per checkWin over a fixed pool of positions
+    printRow("checkWin", measure(repetitions, [&] {
+        constexpr int passes = 256;
+        std::uint64_t wins = 0;
+        auto start = BenchClock::now();
+        for (int p = 0; p < passes; ++p) {
+            for (const Sample& s : samples) wins += checkWin(s.board, s.lastRow, s.lastCol);
+        }
+        double ns = elapsedNs(start);
+        g_sink = g_sink + wins;
+        return ns / (double(passes) * samples.size());
+    }), "ns/call");
+
+    // ns per drop, replaying recorded games without any RNG in the loop
+    printRow("dropPiece", measure(repetitions, [&] {
+        constexpr int passes = 64;
+        std::uint64_t drops = 0;
+        std::uint64_t check = 0;
+        auto start = BenchClock::now();
+        for (int p = 0; p < passes; ++p) {
+            for (const Recorded& game : games) {
+                Board board;
+                resetBoard(board);
+                int player = 1;
+                for (int m = 0; m < game.moves; ++m) {
+                    check += dropPiece(board, game.cols[m], player);
+                    player = 3 - player;
+                }
+                drops += game.moves;
+            }
+        }
+        double ns = elapsedNs(start);
+        g_sink = g_sink + check;
+        return ns / drops;
+    }), "ns/drop");
+
+    // Complete random games from the empty board
+    printRow("random playout", measure(repetitions, [&] {
+        std::uint64_t winners = 0;
+        auto start = BenchClock::now();
+        for (int i = 0; i < PLAYOUTS_PER_REP; ++i) {
+            Board board;
+            resetBoard(board);
+            winners += playRandomGame(board, 1, rng);
+        }
+        double ns = elapsedNs(start);
+        g_sink = g_sink + winners;
+        return PLAYOUTS_PER_REP / (ns * 1e-9);
+    }), "games/s");
+
+    // The same playouts in lockstep, scalar and (when the CPU has it) AVX2
+    for (PlayoutKernel kernel : {PLAYOUT_SCALAR, PLAYOUT_AVX2}) {
+        PlayoutEngine engine(PLAYOUT_DEFAULT_LANES, rng, kernel);
+        if (engine.getKernel() != kernel) continue; // No AVX2 on this CPU
+        Board root;
+        resetBoard(root);
+        engine.setRoot(root);
+        printRow(kernel == PLAYOUT_AVX2 ? "bulk playout avx2" : "bulk playout", measure(repetitions, [&] {
+            auto start = BenchClock::now();
+            PlayoutTally tally = engine.run(PLAYOUTS_PER_REP);
+            double ns = elapsedNs(start);
+            g_sink = g_sink + tally.wins[1];
+            return tally.games / (ns * 1e-9);
+        }), "games/s");
+    }
+
+    // AI search throughput on mid-game positions
+    printRow("search", measure(repetitions, [&] {
+        std::uint64_t nodes = 0;
+        double ns = 0.0;
+        for (int i = 0; i < SEARCH_POSITIONS; ++i) {
+            const Sample& s = samples[i];
+            if (checkDraw(s.board) || checkWin(s.board, s.lastRow, s.lastCol)) continue;
+            int toMove = (s.board.moves % 2 == 0) ? 1 : 2;
+            clearAITable();
+            auto start = BenchClock::now();
+            AIResult result = searchBestMove(s.board, toMove, {AI_MAX_DEPTH, SEARCH_NODE_LIMIT});
+            ns += elapsedNs(start);
+            nodes += result.nodes;
+        }
+        return nodes / (ns * 1e-9);
+    }), "nodes/s");
+
+    // Lazy SMP time-to-depth: same positions and depth, more threads sharing the table
+    for (int threads = 1; ; threads = std::min(threads * 2, hardwareThreads())) {
+        char name[32];
+        std::snprintf(name, sizeof(name), "ttd d%d x%d", TTD_DEPTH, threads);
+        printRow(name, measure(repetitions, [&] {
+            double ns = 0.0;
+            int searched = 0;
+            for (int i = 0; searched < TTD_POSITIONS && i < POSITION_COUNT; ++i) {
+                const Sample& s = samples[i];
+                if (s.board.moves > 12 || checkDraw(s.board) || checkWin(s.board, s.lastRow, s.lastCol)) continue;
+                int toMove = (s.board.moves % 2 == 0) ? 1 : 2;
+                clearAITable();
+                auto start = BenchClock::now();
+                searchBestMove(s.board, toMove, {TTD_DEPTH, UINT64_MAX, threads});
+                ns += elapsedNs(start);
+                ++searched;
+            }
+            return ns * 1e-6 / searched;
+        }), "ms/position");
+        if (threads == hardwareThreads()) break;
+    }
+
+    // Tree-parallel MCTS from the empty board: threads share one tree
+    MCTSSearch mcts;
+    for (int threads = 1; ; threads = std::min(threads * 2, hardwareThreads())) {
+        Board root;
+        resetBoard(root);
+        char name[32];
+        std::snprintf(name, sizeof(name), "mcts x%d", threads);
+        printRow(name, measure(repetitions, [&] {
+            MCTSResult result = mcts.search(root, 1, {0.0, MCTS_PLAYOUTS_PER_REP, threads});
+            g_sink = g_sink + result.nodes;
+            return result.playoutsPerSecond();
+        }), "playouts/s");
+        if (threads == hardwareThreads()) break;
+    }
+
+    return 0;
+}
@@ -0,0 +1,35 @@
+#include "board.h"
+
+/**
+ * @brief Clear every cell and column height
+ */
+template <int Rows, int Cols, int Connect>
+void BasicBoard<Rows, Cols, Connect>::reset() {
+    pieces[0] = 0;
+    pieces[1] = 0;
+    for (int c = 0; c < Cols; ++c) {
+        height[c] = 0;
+    }
+    moves = 0;
+    threats[0] = 0;
+    threats[1] = 0;
+    winner = 0;
+}
+
+/**
+ * @brief Read the owner of a single cell
+ * @param row Screen row (0 = top)
+ * @param col Column index
+ * @return 0 if empty, 1 for Red, 2 for Yellow
+ */
+template <int Rows, int Cols, int Connect>
+int BasicBoard<Rows, Cols, Connect>::cell(int row, int col) const {
+    std::uint64_t bit = std::uint64_t(1) << (col * COLUMN_BITS + (Rows - 1 - row));
+    if (pieces[0] & bit) return 1;
+    if (pieces[1] & bit) return 2;
+    return 0;
+}
+
+template struct BasicBoard<6, 7, 4>;
+template struct BasicBoard<7, 8, 4>;
+template struct BasicBoard<6, 9, 5>;
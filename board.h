@@ -0,0 +1,205 @@
+#ifndef BOARD_H
+#define BOARD_H
+
+#include <cstdint>
+
+/**
+ * @brief Connect-N position stored as one bitmask per player
+ *
+ * Bitboard layout: each column owns (Rows + 1) consecutive bits, bottom row
+ * first. The extra bit on top of every column stays empty so that shifts
+ * never carry a line from one column into the next.
+ *
+ * Every mask and shift is a compile-time constant of the instantiation, so
+ * each variant gets its own fully unrolled, branch-free threat test.
+ *
+ * Each player's threat mask (cells that would complete a line, i.e. the
+ * gap of an open three in Connect Four) and the winner are updated inside
+ * drop(), so win, draw and threat queries are single mask operations.
+ *
+ * Rows passed to and returned from the public functions use screen
+ * coordinates (row 0 = top), matching the way the board is drawn.
+ */
+template <int Rows, int Cols, int Connect>
+struct BasicBoard {
+    static constexpr int ROWS = Rows;
+    static constexpr int COLS = Cols;
+    static constexpr int CONNECT = Connect;
+    static constexpr int COLUMN_BITS = Rows + 1;
+    static constexpr int CELLS = Rows * Cols;
+
+    static_assert(Cols * COLUMN_BITS <= 64, "Board does not fit in a 64-bit mask");
+    static_assert(Connect >= 2 && Connect <= Rows && Connect <= Cols, "Line length does not fit the board");
+
+    // Bottom cell of every column
+    static constexpr std::uint64_t BOTTOM_MASK = [] {
+        std::uint64_t mask = 0;
+        for (int c = 0; c < Cols; ++c) mask |= std::uint64_t(1) << (c * COLUMN_BITS);
+        return mask;
+    }();
+    // Every playable cell (sentinel bits excluded)
+    static constexpr std::uint64_t BOARD_MASK = BOTTOM_MASK * ((std::uint64_t(1) << Rows) - 1);
+
+    std::uint64_t pieces[2];   // Occupied cells of Player 1 (Red) and Player 2 (Yellow)
+    std::uint8_t height[Cols]; // Number of pieces already in each column
+    int moves;                 // Number of pieces on the board
+    std::uint64_t threats[2];  // Cells (empty or not) that would complete a line for each player
+    int winner;                // Player whose drop completed a line, 0 if none yet
+
+    void reset();
+    int cell(int row, int col) const;
+
+    /**
+     * @brief Check whether a piece can be dropped into a column
+     */
+    bool canPlay(int col) const {
+        return col >= 0 && col < Cols && height[col] < Rows;
+    }
+
+    /**
+     * @brief Screen row where the next piece in a column will land
+     * @return Row index (0 = top), or -1 if the column is full or invalid
+     */
+    int landingRow(int col) const {
+        return canPlay(col) ? Rows - 1 - height[col] : -1;
+    }
+
+    /**
+     * @brief Drop a piece into a column
+     * @param col Column index
+     * @param player Player number (1=Red, 2=Yellow)
+     * @return Screen row where the piece landed, or -1 if the column is full
+     */
+    int drop(int col, int player) {
+        if (!canPlay(col)) return -1;
+        int row = landingRow(col);
+        std::uint64_t bit = std::uint64_t(1) << (col * COLUMN_BITS + height[col]);
+        std::uint64_t& own = pieces[player - 1];
+        std::uint64_t& ownThreats = threats[player - 1];
+        if ((bit & ownThreats) && !winner) winner = player;
+        own |= bit;
+        // Only the mover's threats change; the opponent's stay valid because
+        // threats are kept regardless of occupancy
+        ownThreats = threatCells(own);
+        ++height[col];
+        ++moves;
+        return row;
+    }
+
+    /**
+     * @brief Check whether a player has completed a line
+     */
+    bool hasWon(int player) const {
+        return winner == player;
+    }
+
+    /**
+     * @brief Mask of all occupied cells
+     */
+    std::uint64_t occupied() const {
+        return pieces[0] | pieces[1];
+    }
+
+    /**
+     * @brief Mask of the cells a piece can be dropped into right now
+     */
+    std::uint64_t playable() const {
+        return (occupied() + BOTTOM_MASK) & BOARD_MASK;
+    }
+
+    /**
+     * @brief Empty cells that would complete a line for a player
+     */
+    std::uint64_t openThreats(int player) const {
+        return threats[player - 1] & (BOARD_MASK ^ occupied());
+    }
+
+    /**
+     * @brief Check whether a player could complete a line with their next piece
+     */
+    bool canWinNext(int player) const {
+        return (threats[player - 1] & playable()) != 0;
+    }
+
+    /**
+     * @brief Check whether every cell is occupied
+     */
+    bool isFull() const {
+        return moves == CELLS;
+    }
+
+    /**
+     * @brief Key that uniquely identifies the position
+     *
+     * Adds the side-to-move's mask to the occupancy mask; because columns fill
+     * from the bottom this is unique and needs at most COLUMN_BITS bits per column.
+     * Player 1 moves on even move counts.
+     */
+    std::uint64_t key() const {
+        return pieces[moves & 1] + (pieces[0] | pieces[1]);
+    }
+
+    /**
+     * @brief Cells (empty or not) that would complete a line for a mask
+     */
+    static constexpr std::uint64_t threatCells(std::uint64_t bits) {
+        return (gapCells<0, 1>(bits) | gapCells<0, COLUMN_BITS>(bits) |
+                gapCells<0, COLUMN_BITS - 1>(bits) | gapCells<0, COLUMN_BITS + 1>(bits)) & BOARD_MASK;
+    }
+
+    /**
+     * @brief Cells that would complete a line along one direction
+     *
+     * A cell completes a line when Before pieces end just below it and
+     * Connect - 1 - Before pieces start just above it (along Shift).
+     * Recurses over every split Before = First .. Connect - 1.
+     */
+    template <int First, int Shift>
+    static constexpr std::uint64_t gapCells(std::uint64_t bits) {
+        constexpr int Before = First;
+        constexpr int After = Connect - 1 - First;
+        std::uint64_t cells = ~std::uint64_t(0);
+        if constexpr (Before > 0) cells &= lineStarts<Before, Shift>(bits) << (Before * Shift);
+        if constexpr (After > 0) cells &= lineStarts<After, Shift>(bits) >> Shift;
+        if constexpr (First + 1 < Connect) {
+            return cells | gapCells<First + 1, Shift>(bits);
+        } else {
+            return cells;
+        }
+    }
+
+    /**
+     * @brief Cells that start a run of Length pieces along one direction
+     *
+     * Runs double in length with each step (1, 2, 4, ...), with one extra
+     * AND for odd lengths, so a line of N costs about log2(N) shift-ANDs.
+     */
+    template <int Length, int Shift>
+    static constexpr std::uint64_t lineStarts(std::uint64_t bits) {
+        if constexpr (Length == 1) {
+            return bits;
+        } else if constexpr (Length % 2 == 0) {
+            std::uint64_t half = lineStarts<Length / 2, Shift>(bits);
+            return half & (half >> (Length / 2 * Shift));
+        } else {
+            return lineStarts<Length - 1, Shift>(bits) & (bits >> ((Length - 1) * Shift));
+        }
+    }
+};
+
+// Variants in use. Board is the standard game played by the GUI and the AI.
+using Board = BasicBoard<6, 7, 4>;
+using Board7x8 = BasicBoard<7, 8, 4>;
+using BoardConnect5 = BasicBoard<6, 9, 5>; // Connect 5 on the usual 6x9 board
+
+// Instantiated once in board.cpp
+extern template struct BasicBoard<6, 7, 4>;
+extern template struct BasicBoard<7, 8, 4>;
+extern template struct BasicBoard<6, 9, 5>;
+
+// Dimensions of the standard board
+constexpr int ROWS = Board::ROWS;
+constexpr int COLS = Board::COLS;
+constexpr int COLUMN_BITS = Board::COLUMN_BITS;
+
+#endif // BOARD_H
@@ -0,0 +1,118 @@
+// Offline opening book generator.
+// Build and run with: make book
+// Usage: connect4_bookgen [--depth D] [--nodes N] [--threads T] [--output PATH]
+
+#include "ai.h"
+#include "opening_book.h"
+#include "parallel.h"
+#include "rules.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct BookGenConfig {
+    int depth = 6;                    // Store every position up to this ply
+    std::uint64_t nodeLimit = 2000000; // Search budget per position
+    int threads = 0;                  // 0 = all hardware threads
+    std::string output = OPENING_BOOK_PATH;
+};
+
+struct BookPosition {
+    std::uint64_t key; // Canonical key, used to remove duplicates and mirrors
+    Board board;
+};
+
+bool parseArgs(int argc, char* argv[], BookGenConfig& config) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--depth" && hasValue) config.depth = std::atoi(argv[++i]);
+        else if (arg == "--nodes" && hasValue) config.nodeLimit = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--threads" && hasValue) config.threads = std::atoi(argv[++i]);
+        else if (arg == "--output" && hasValue) config.output = argv[++i];
+        else return false;
+    }
+    return config.depth >= 0 && config.depth < ROWS * COLS;
+}
+
+/**
+ * @brief Every distinct non-terminal position reachable in exactly `ply` moves
+ *        from the previous ply, mirror images merged
+ */
+std::vector<BookPosition> expand(const std::vector<BookPosition>& previous) {
+    std::vector<BookPosition> next;
+    for (const BookPosition& pos : previous) {
+        int player = (pos.board.moves % 2 == 0) ? 1 : 2;
+        for (int col = 0; col < COLS; ++col) {
+            if (!pos.board.canPlay(col)) continue;
+            BookPosition child = pos;
+            int row = dropPiece(child.board, col, player);
+            if (checkWin(child.board, row, col) || checkDraw(child.board)) continue;
+            bool mirrored;
+            child.key = canonicalBookKey(child.board, mirrored);
+            next.push_back(child);
+        }
+    }
+    std::sort(next.begin(), next.end(),
+              [](const BookPosition& a, const BookPosition& b) { return a.key < b.key; });
+    next.erase(std::unique(next.begin(), next.end(),
+                           [](const BookPosition& a, const BookPosition& b) { return a.key == b.key; }),
+               next.end());
+    return next;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    BookGenConfig config;
+    if (!parseArgs(argc, argv, config)) {
+        std::fprintf(stderr, "Usage: %s [--depth D] [--nodes N] [--threads T] [--output PATH]\n", argv[0]);
+        return 1;
+    }
+    int threads = config.threads > 0 ? config.threads : hardwareThreads();
+
+    // 1. Enumerate positions ply by ply
+    std::vector<BookPosition> positions;
+    std::vector<BookPosition> frontier(1);
+    resetBoard(frontier[0].board);
+    bool unused;
+    frontier[0].key = canonicalBookKey(frontier[0].board, unused);
+    for (int ply = 0; ply <= config.depth; ++ply) {
+        if (ply > 0) frontier = expand(frontier);
+        std::printf("ply %2d: %zu positions\n", ply, frontier.size());
+        positions.insert(positions.end(), frontier.begin(), frontier.end());
+    }
+
+    // 2. Search every position in parallel; the workers share one table,
+    //    so it is allocated here rather than by whichever search starts first
+    clearAITable();
+    std::vector<std::uint64_t> entries(positions.size());
+    auto start = std::chrono::steady_clock::now();
+    parallelFor(static_cast<int>(positions.size()), threads, [&](int i, int) {
+        const Board& board = positions[i].board;
+        int player = (board.moves % 2 == 0) ? 1 : 2;
+        AIResult result = searchBestMove(board, player, {ROWS * COLS, config.nodeLimit});
+
+        // Store the move in the same orientation as the canonical key
+        bool mirrored;
+        std::uint64_t key = canonicalBookKey(board, mirrored);
+        int column = mirrored ? COLS - 1 - result.column : result.column;
+        entries[i] = packBookEntry(key, column, result.score);
+    });
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // 3. Write the sorted book
+    if (!writeOpeningBook(config.output.c_str(), entries, config.depth)) {
+        std::fprintf(stderr, "Failed to write %s\n", config.output.c_str());
+        return 1;
+    }
+    std::printf("Wrote %zu entries (%zu bytes) to %s in %.1f s on %d threads\n",
+                entries.size(), sizeof(BookHeader) + entries.size() * sizeof(std::uint64_t),
+                config.output.c_str(), seconds, threads);
+    return 0;
+}
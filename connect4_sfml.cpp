@@ -2,26 +2,41 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include "ai.h"
+#include "analysis.h"
+#include "anytime_search.h"
 #include "animation.h"
+#include "asset_loader.h"
+#include "board.h"
+#include "frame_profiler.h"
+#include "game_record.h"
+#include "layout.h"
+#include "mcts.h"
+#include "opening_book.h"
+#include "parallel.h"
 #include "popup.h"
+#include "rules.h"
+#include "solved_cache.h"
 #include "start_screen.h"
+#include "text_cache.h"
+#include "trace.h"
+#include <algorithm>
 #include <cmath>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <future>
+#include <optional>
 
 // --- Game State Enum ---
 enum GameState
 {
+    LOADING,      // Assets still loading in the background
     START_SCREEN,
     PLAYING
 };
 
-// --- Game Constants ---
-constexpr int ROWS = 6;
-constexpr int COLS = 7;
-constexpr float CELL_SIZE = 100.0f;   // Size of each cell in pixels
-constexpr float PIECE_RADIUS = 40.0f; // Radius of the game pieces
-constexpr int WINDOW_WIDTH = static_cast<int>(COLS * CELL_SIZE);
-constexpr int WINDOW_HEIGHT = static_cast<int>(ROWS * CELL_SIZE + 50.0f); // Extra height for status bar
-
 // --- Sprite Constants (based on sprite sheet dimensions) ---
 // SFML 3.x Fix: IntRect now uses Vector2 for position and size
 // Player 1 Turn sprite: top red button in sprite sheet
@@ -33,198 +48,409 @@ const sf::IntRect GAME_OVER_RECT(sf::Vector2i(85, 465), sf::Vector2i(485, 100));
 // Restart button sprite: bottom blue button in sprite sheet
 const sf::IntRect RESTART_RECT(sf::Vector2i(190, 680), sf::Vector2i(275, 100));
 
-// --- Global Sprite Textures ---
-std::unique_ptr<sf::Texture> g_uiTexture = nullptr;
-std::unique_ptr<sf::Texture> g_drawTexture = nullptr;
-std::unique_ptr<sf::Texture> g_startTexture = nullptr;
-
 // --- Game State Variables ---
-GameState currentState = START_SCREEN; // Start at the start screen
-// Board: 0=Empty, 1=Red, 2=Yellow
-std::vector<std::vector<int>> board(ROWS, std::vector<int>(COLS, 0));
+GameState currentState = LOADING; // Show the start screen once assets are loaded
+// Board: bitboard position (see board.h)
+Board g_board = {{0, 0}, {0}, 0, {0, 0}, 0};
 int currentPlayer = 1; // 1 for Red, 2 for Yellow
 bool gameOver = false;
 std::string statusText = "Player 1 (Red)'s Turn";
 
+// --- Game Archive ---
+// Every game (finished or abandoned) is appended to GAME_RECORD_PATH
+GameRecord g_record = {0, RESULT_UNFINISHED, {0}};
+GameRecordWriter g_recordWriter;
+std::uint64_t g_winningCells = 0; // Cells to flash once the winning piece lands
+
+// --- Fixed Timestep ---
+// Game logic advances in fixed steps so the physics and the turn timer do not
+// depend on the frame rate; rendering interpolates between the last two steps.
+constexpr int SIM_TICKS_PER_SECOND = 120;
+constexpr float SIM_TIMESTEP = 1.0f / SIM_TICKS_PER_SECOND;
+constexpr float MAX_FRAME_TIME = 0.25f; // Longer frames are cut short instead of spiralling
+
 // --- Turn Timer Variables ---
 constexpr float TURN_TIME_LIMIT = 10.0f; // 10 seconds per turn
-float currentTurnTime = 0.0f;
+constexpr int TURN_TICK_LIMIT = static_cast<int>(TURN_TIME_LIMIT * SIM_TICKS_PER_SECOND);
+int currentTurnTicks = 0; // Simulation steps taken this turn
 bool timerActive = false;
 
+// --- Headless Mode ---
+// --headless plays CPU vs CPU games through updateGame() without a window,
+// as fast as the machine allows
+bool g_headless = false;
+std::uint64_t g_headlessRng = 1;         // Chooses the random opening plies
+constexpr int HEADLESS_RANDOM_PLIES = 4; // So that deterministic AI games differ
+
+// --- Redraw Scheduling ---
+// How the main loop waits between frames
+enum RedrawMode
+{
+    REDRAW_CONTINUOUS, // Something is moving: render every frame (60 FPS)
+    REDRAW_ON_TICK,    // Only the turn timer runs: wake up when its digit changes
+    REDRAW_ON_EVENT    // Nothing changes on its own: block until input arrives
+};
+
+// --- Computer Opponent ---
+bool g_player2IsCPU = false; // Player 2 is played by the AI (--cpu flag or C key)
+// In the window the computer thinks on a worker thread for the rest of its
+// turn and moves just before the clock runs out (or as soon as it is sure).
+// During the human's turn the same search ponders the expected reply; if the
+// human plays it, the search simply carries on and the time already spent
+// counts towards the computer's turn.
+AnytimeSearch g_cpuSearch;
+float g_cpuThinkBudget = 0.0f;          // Seconds of thinking the current search may use
+constexpr float CPU_TURN_MARGIN = 0.2f; // Turn seconds left unused so the move always beats the clock
+// When a human's clock runs out the computer plays for them. That move is
+// searched off the UI thread like the computer's own, and played a few
+// ticks later: the anytime search gets TIMEOUT_MOVE_TIME, or with --mcts
+// the Monte Carlo tree search gets the same budget on a worker thread.
+constexpr double TIMEOUT_MOVE_TIME = AI_MOVE_TIME;
+bool g_mctsFallback = false;
+MCTSSearch g_mcts;
+std::future<MCTSResult> g_mctsMove; // Valid while the MCTS timeout move is being searched
+std::uint64_t g_mctsMovePosition = 0; // Board::key() it is being searched for
+
+// --- Analysis Overlay ---
+// The A key shows per-column scores from the background analysis worker
+// (see analysis.h). A new position is handed over each time a piece lands.
+constexpr std::uint64_t NO_POSITION = ~std::uint64_t(0);
+bool g_showAnalysis = false;
+AnalysisResult g_analysis = {};              // Newest result received (all columns COLUMN_FULL = none yet)
+std::uint64_t g_analysisPosition = NO_POSITION; // Position last handed to the worker
+// One label per column, laid out again only when its string changes. Scores
+// differ from position to position, so they are kept out of the text cache.
+struct AnalysisLabel
+{
+    std::optional<sf::Text> text;
+    std::string shown;
+};
+AnalysisLabel g_analysisLabels[COLS];
+// Dark backings behind the labels, one quad per column, drawn in one call
+constexpr float LABEL_CENTER_Y = 14.0f;
+constexpr float LABEL_BACKING_WIDTH = 48.0f;
+constexpr float LABEL_BACKING_HEIGHT = 22.0f;
+constexpr int LABEL_BACKING_VERTICES = 6;
+const sf::Color LABEL_BACKING_COLOR(0, 0, 0, 170);
+sf::VertexArray g_labelBackings(sf::PrimitiveType::Triangles);
+
 // --- Exit Button State ---
 static float g_exitButtonX = 0.0f;
 static float g_exitButtonY = 0.0f;
 static float g_exitButtonWidth = 0.0f;
 static float g_exitButtonHeight = 0.0f;
 
+// --- Batched Board Geometry ---
+// The whole board (background, slots and pieces) is one triangle list drawn
+// with a single call. Positions are built once; colours are rewritten only
+// when the pieces on the board change.
+constexpr int CIRCLE_SEGMENTS = 32;
+constexpr float SLOT_OUTLINE = 2.0f;
+constexpr int BACKGROUND_VERTICES = 6;
+constexpr int CELL_FILL_VERTICES = CIRCLE_SEGMENTS * 3; // Triangle fan around the centre
+constexpr int CELL_RING_VERTICES = CIRCLE_SEGMENTS * 6; // Outline ring, two triangles per segment
+constexpr int CELL_VERTICES = CELL_FILL_VERTICES + CELL_RING_VERTICES;
+const sf::Color BOARD_COLOR(0, 0, 150);      // Dark Blue
+const sf::Color EMPTY_SLOT_COLOR(20, 20, 20);
+const sf::Color SLOT_OUTLINE_COLOR(0, 0, 100);
+sf::VertexArray g_boardVertices(sf::PrimitiveType::Triangles);
+std::uint64_t g_drawnPieces[2] = {~std::uint64_t(0), ~std::uint64_t(0)}; // Masks the colours were built for
+
 // --- Function Declarations ---
-bool checkWin(int lastRow, int lastCol);
-int dropPiece(int col, int player);
 void resetGame();
-void drawBoard(sf::RenderWindow &window);
+void archiveGame();
+void buildBoardGeometry();
+void updateBoardColors();
+void drawBoard(sf::RenderWindow &window, const sf::Font &font);
+void buildLabelBackings();
+void drawAnalysis(sf::RenderWindow &window, const sf::Font &font);
+bool refreshAnalysis();
 void drawTimer(sf::RenderWindow &window, const sf::Font &font);
 void drawStatus(sf::RenderWindow &window, const sf::Font &font);
 void drawExitButton(sf::RenderWindow& window, const sf::Font& font);
 bool isClickOnGameExitButton(float x, float y);
+bool isCPUTurn();
+int pickCPUMove();
+bool isTurnTimedOut();
+int updateTimeoutMove();
+void cancelTimeoutMove();
+int updateCPUSearch();
+void startPondering();
+void playMove(int col);
+void showGameOver();
+RedrawMode getRedrawMode();
+float getTurnTimeRemaining();
+float getTimeUntilTimerTick();
+void updateGame();
+void advanceSimulation(float &accumulator);
+int runHeadless(int games, std::uint64_t seed);
+void writeTraceFile();
+
+/**
+ * @brief Appends the current game to the archive and flushes it at once, so
+ *        a crash or a killed window never loses a finished game.
+ */
+void archiveGame()
+{
+    if (g_recordWriter.write(g_record))
+        g_recordWriter.flush();
+}
 
 /**
  * @brief Resets the game board and state variables for a new game.
  */
 void resetGame()
 {
-    for (int r = 0; r < ROWS; ++r)
+    // Finished games were archived when they ended; keep abandoned ones too
+    if (!gameOver && g_record.plies > 0)
     {
-        for (int c = 0; c < COLS; ++c)
-        {
-            board[r][c] = 0;
-        }
+        archiveGame();
     }
+    g_record.clear();
+
+    resetBoard(g_board);
     currentPlayer = 1;
     gameOver = false;
     statusText = "Player 1 (Red)'s Turn";
-    currentTurnTime = 0.0f;
+    currentTurnTicks = 0;
     timerActive = true;
-    resetAnimation();
+    g_winningCells = 0;
+    g_cpuSearch.stop();
+    cancelTimeoutMove();
+    resetAnimations();
     resetPopup();
 }
 
 /**
- * @brief Checks all directions (horizontal, vertical, diagonals) for 4 in a row.
- * @param lastRow The row of the last piece placed.
- * @param lastCol The column of the last piece placed.
- * @return true if the last move resulted in a win, false otherwise.
+ * @brief Builds the vertex positions of the board background and all 42 slots.
  */
-bool checkWin(int lastRow, int lastCol)
+void buildBoardGeometry()
 {
-    if (lastRow == -1)
-        return false;
+    g_boardVertices.resize(BACKGROUND_VERTICES + ROWS * COLS * CELL_VERTICES);
 
-    int player = board[lastRow][lastCol];
+    // 1. Blue board background (two triangles)
+    const sf::Vector2f corners[BACKGROUND_VERTICES] = {
+        {0.0f, 0.0f}, {WINDOW_WIDTH, 0.0f}, {WINDOW_WIDTH, ROWS * CELL_SIZE},
+        {0.0f, 0.0f}, {WINDOW_WIDTH, ROWS * CELL_SIZE}, {0.0f, ROWS * CELL_SIZE}};
+    for (int i = 0; i < BACKGROUND_VERTICES; ++i)
+    {
+        g_boardVertices[i].position = corners[i];
+        g_boardVertices[i].color = BOARD_COLOR;
+    }
 
-    // Helper lambda to count consecutive pieces in a direction
-    auto countDir = [&](int dr, int dc)
+    // 2. One filled circle plus an outline ring per cell
+    for (int r = 0; r < ROWS; ++r)
     {
-        int count = 0;
-        // Check both directions from the center piece
-        for (int i = -3; i <= 3; ++i)
+        for (int c = 0; c < COLS; ++c)
         {
-            int r = lastRow + i * dr;
-            int c = lastCol + i * dc;
+            sf::Vector2f center(c * CELL_SIZE + CELL_SIZE / 2.0f, r * CELL_SIZE + CELL_SIZE / 2.0f);
+            std::size_t base = BACKGROUND_VERTICES + (r * COLS + c) * CELL_VERTICES;
 
-            if (r >= 0 && r < ROWS && c >= 0 && c < COLS)
+            for (int i = 0; i < CIRCLE_SEGMENTS; ++i)
             {
-                if (board[r][c] == player)
-                {
-                    count++;
-                    if (count >= 4)
-                        return true;
-                }
-                else
-                {
-                    count = 0;
-                }
+                float a0 = 2.0f * 3.14159265f * i / CIRCLE_SEGMENTS;
+                float a1 = 2.0f * 3.14159265f * (i + 1) / CIRCLE_SEGMENTS;
+                sf::Vector2f d0(std::cos(a0), std::sin(a0));
+                sf::Vector2f d1(std::cos(a1), std::sin(a1));
+                sf::Vector2f in0 = center + d0 * PIECE_RADIUS;
+                sf::Vector2f in1 = center + d1 * PIECE_RADIUS;
+                sf::Vector2f out0 = center + d0 * (PIECE_RADIUS + SLOT_OUTLINE);
+                sf::Vector2f out1 = center + d1 * (PIECE_RADIUS + SLOT_OUTLINE);
+
+                std::size_t fill = base + i * 3;
+                g_boardVertices[fill + 0].position = center;
+                g_boardVertices[fill + 1].position = in0;
+                g_boardVertices[fill + 2].position = in1;
+
+                std::size_t ring = base + CELL_FILL_VERTICES + i * 6;
+                g_boardVertices[ring + 0].position = in0;
+                g_boardVertices[ring + 1].position = out0;
+                g_boardVertices[ring + 2].position = out1;
+                g_boardVertices[ring + 3].position = in0;
+                g_boardVertices[ring + 4].position = out1;
+                g_boardVertices[ring + 5].position = in1;
             }
         }
-        return false;
-    };
-
-    // 1. Check Horizontal (dr=0, dc=1)
-    if (countDir(0, 1))
-        return true;
-
-    // 2. Check Vertical (dr=1, dc=0)
-    if (countDir(1, 0))
-        return true;
-
-    // 3. Check Diagonal (top-left to bottom-right) (dr=1, dc=1)
-    if (countDir(1, 1))
-        return true;
-
-    // 4. Check Diagonal (top-right to bottom-left) (dr=1, dc=-1)
-    if (countDir(1, -1))
-        return true;
+    }
 
-    return false;
+    // Force the colours to be written on the next update
+    g_drawnPieces[0] = ~std::uint64_t(0);
+    g_drawnPieces[1] = ~std::uint64_t(0);
 }
 
 /**
- * @brief Finds the lowest available row in a column and places the piece.
+ * @brief Recolours the slots, but only if the pieces changed since the last call.
+ *        Pieces that are still falling are left out until they land.
  */
-int dropPiece(int col, int player)
+void updateBoardColors()
 {
-    if (col < 0 || col >= COLS)
-        return -1;
+    std::uint64_t falling = getFallingCells();
+    std::uint64_t shown[2] = {g_board.pieces[0] & ~falling, g_board.pieces[1] & ~falling};
+    if (shown[0] == g_drawnPieces[0] && shown[1] == g_drawnPieces[1])
+        return;
 
-    for (int r = ROWS - 1; r >= 0; --r)
+    for (int r = 0; r < ROWS; ++r)
     {
-        if (board[r][col] == 0)
+        for (int c = 0; c < COLS; ++c)
         {
-            board[r][col] = player;
-            return r; // Return the row where the piece landed
+            std::uint64_t bit = std::uint64_t(1) << (c * COLUMN_BITS + (ROWS - 1 - r));
+            int owner = (shown[0] & bit) ? 1 : ((shown[1] & bit) ? 2 : 0);
+            sf::Color fillColor = EMPTY_SLOT_COLOR;
+            // Pieces have no outline: paint their ring in the board colour
+            sf::Color ringColor = BOARD_COLOR;
+            if (owner == 1)
+            {
+                fillColor = sf::Color::Red;
+            }
+            else if (owner == 2)
+            {
+                fillColor = sf::Color::Yellow;
+            }
+            else
+            {
+                ringColor = SLOT_OUTLINE_COLOR;
+            }
+
+            std::size_t base = BACKGROUND_VERTICES + (r * COLS + c) * CELL_VERTICES;
+            for (int i = 0; i < CELL_FILL_VERTICES; ++i)
+                g_boardVertices[base + i].color = fillColor;
+            for (int i = 0; i < CELL_RING_VERTICES; ++i)
+                g_boardVertices[base + CELL_FILL_VERTICES + i].color = ringColor;
         }
     }
-    return -1; // Column is full
+
+    g_drawnPieces[0] = shown[0];
+    g_drawnPieces[1] = shown[1];
 }
 
 /**
- * @brief Checks for a draw condition (board is full).
+ * @brief Draws the 6x7 Connect Four board, including the grid and the pieces,
+ *        as a single batched draw call, with the analysis overlay on top.
  */
-bool checkDraw()
+void drawBoard(sf::RenderWindow &window, const sf::Font &font)
 {
+    if (g_boardVertices.getVertexCount() == 0)
+        buildBoardGeometry();
+    updateBoardColors();
+    window.draw(g_boardVertices);
+    drawAnalysis(window, font);
+}
+
+/**
+ * @brief Builds the vertex positions of the seven label backings.
+ */
+void buildLabelBackings()
+{
+    g_labelBackings.resize(COLS * LABEL_BACKING_VERTICES);
     for (int c = 0; c < COLS; ++c)
     {
-        if (board[0][c] == 0)
-        {
-            return false;
-        }
+        float left = c * CELL_SIZE + (CELL_SIZE - LABEL_BACKING_WIDTH) / 2.0f;
+        float top = LABEL_CENTER_Y - LABEL_BACKING_HEIGHT / 2.0f;
+        float right = left + LABEL_BACKING_WIDTH;
+        float bottom = top + LABEL_BACKING_HEIGHT;
+        const sf::Vector2f corners[LABEL_BACKING_VERTICES] = {
+            {left, top}, {right, top}, {right, bottom},
+            {left, top}, {right, bottom}, {left, bottom}};
+        for (int i = 0; i < LABEL_BACKING_VERTICES; ++i)
+            g_labelBackings[c * LABEL_BACKING_VERTICES + i].position = corners[i];
     }
-    return true;
 }
 
 /**
- * @brief Draws the 6x7 Connect Four board, including the grid and the pieces.
+ * @brief Draws the latest analysis scores above the columns.
+ *        W3 / L3 = forced win / loss in 3 of the mover's moves, D = draw,
+ *        a signed number = heuristic score at the depth searched so far.
+ *        The backings of all columns go out in one draw call; columns
+ *        without a label get transparent ones.
  */
-void drawBoard(sf::RenderWindow &window)
+void drawAnalysis(sf::RenderWindow &window, const sf::Font &font)
 {
-    // 1. Draw the Blue Board Background
-    sf::RectangleShape boardBg(sf::Vector2f(WINDOW_WIDTH, ROWS * CELL_SIZE));
-    boardBg.setFillColor(sf::Color(0, 0, 150)); // Dark Blue
-    // SFML 3.x Fix: use sf::Vector2f
-    boardBg.setPosition(sf::Vector2f(0.0f, 0.0f));
-    window.draw(boardBg);
-
-    // 2. Draw the Pieces and Empty Slots
-    for (int r = 0; r < ROWS; ++r)
+    // Results for an earlier position are stale; the worker is already on the new one
+    if (!g_showAnalysis || gameOver || g_analysis.position != g_board.key())
+        return;
+
+    if (g_labelBackings.getVertexCount() == 0)
+        buildLabelBackings();
+
+    char labels[COLS][16];
+    sf::Color colors[COLS];
+    bool shown[COLS];
+    for (int c = 0; c < COLS; ++c)
     {
-        for (int c = 0; c < COLS; ++c)
+        const ColumnAnalysis &column = g_analysis.columns[c];
+        char *label = labels[c];
+        colors[c] = sf::Color::White;
+        shown[c] = true;
+        switch (column.verdict)
         {
-            float centerX = c * CELL_SIZE + CELL_SIZE / 2.0f;
-            float centerY = r * CELL_SIZE + CELL_SIZE / 2.0f;
+        case COLUMN_FULL:
+        case COLUMN_PENDING:
+            shown[c] = false;
+            break;
+        case COLUMN_WIN:
+            std::snprintf(label, sizeof(labels[c]), "W%d", (column.plies + 1) / 2);
+            colors[c] = sf::Color(80, 255, 80);
+            break;
+        case COLUMN_LOSS:
+            std::snprintf(label, sizeof(labels[c]), "L%d", column.plies / 2);
+            colors[c] = sf::Color(255, 90, 90);
+            break;
+        case COLUMN_DRAW:
+            std::snprintf(label, sizeof(labels[c]), "D");
+            colors[c] = sf::Color(190, 190, 190);
+            break;
+        default:
+            std::snprintf(label, sizeof(labels[c]), "%+d", column.score);
+            break;
+        }
 
-            sf::CircleShape piece(PIECE_RADIUS);
-            // SFML 3.x Fix: use sf::Vector2f
-            piece.setOrigin(sf::Vector2f(PIECE_RADIUS, PIECE_RADIUS));
-            // SFML 3.x Fix: use sf::Vector2f
-            piece.setPosition(sf::Vector2f(centerX, centerY));
+        sf::Color backing = shown[c] ? LABEL_BACKING_COLOR : sf::Color::Transparent;
+        for (int i = 0; i < LABEL_BACKING_VERTICES; ++i)
+            g_labelBackings[c * LABEL_BACKING_VERTICES + i].color = backing;
+    }
+    window.draw(g_labelBackings);
 
-            if (board[r][c] == 1)
-            {
-                piece.setFillColor(sf::Color::Red);
-            }
-            else if (board[r][c] == 2)
-            {
-                piece.setFillColor(sf::Color::Yellow);
-            }
-            else
-            {
-                piece.setFillColor(sf::Color(20, 20, 20));
-                piece.setOutlineThickness(2);
-                piece.setOutlineColor(sf::Color(0, 0, 100));
-            }
+    for (int c = 0; c < COLS; ++c)
+    {
+        if (!shown[c])
+            continue;
 
-            window.draw(piece);
+        AnalysisLabel &cached = g_analysisLabels[c];
+        if (!cached.text)
+        {
+            cached.text.emplace(font, "", 16);
+            cached.text->setStyle(sf::Text::Bold);
         }
+        if (cached.shown != labels[c])
+        {
+            cached.shown = labels[c];
+            cached.text->setString(cached.shown);
+            sf::FloatRect bounds = cached.text->getLocalBounds();
+            cached.text->setOrigin(sf::Vector2f(bounds.position.x + bounds.size.x / 2.0f,
+                                                bounds.position.y + bounds.size.y / 2.0f));
+        }
+        cached.text->setFillColor(colors[c]);
+        cached.text->setPosition(sf::Vector2f(c * CELL_SIZE + CELL_SIZE / 2.0f, LABEL_CENTER_Y));
+        window.draw(*cached.text);
+    }
+}
+
+/**
+ * @brief Hands the position to the analysis worker once its last piece has
+ *        landed, and picks up any result the worker posted. Never waits.
+ * @return true if the overlay has to be redrawn
+ */
+bool refreshAnalysis()
+{
+    if (!g_showAnalysis || currentState != PLAYING)
+        return false;
+
+    if (!gameOver && getActiveDropCount() == 0 && g_board.key() != g_analysisPosition)
+    {
+        g_analysisPosition = g_board.key();
+        requestAnalysis(g_board);
     }
+    return pollAnalysis(g_analysis);
 }
 
 /**
@@ -235,9 +461,7 @@ void drawTimer(sf::RenderWindow &window, const sf::Font &font)
     if (!timerActive || gameOver)
         return;
 
-    float timeRemaining = TURN_TIME_LIMIT - currentTurnTime;
-    if (timeRemaining < 0.0f)
-        timeRemaining = 0.0f;
+    float timeRemaining = getTurnTimeRemaining();
 
     // Draw timer circle
     sf::CircleShape timerCircle(25.0f);
@@ -261,18 +485,26 @@ void drawTimer(sf::RenderWindow &window, const sf::Font &font)
     window.draw(timerCircle);
 
     // Draw time number
+    // The timer owns its text, laid out again only when the digit changes once per second
+    static std::optional<sf::Text> timeText;
+    static int shownSeconds = -1;
     int seconds = static_cast<int>(std::ceil(timeRemaining));
-    sf::Text timeText(font, std::to_string(seconds));
-    timeText.setCharacterSize(24);
-    timeText.setFillColor(sf::Color::White);
-    timeText.setStyle(sf::Text::Bold);
-
-    sf::FloatRect textBounds = timeText.getLocalBounds();
-    timeText.setOrigin(sf::Vector2f(
-        textBounds.position.x + textBounds.size.x / 2.0f,
-        textBounds.position.y + textBounds.size.y / 2.0f));
-    timeText.setPosition(sf::Vector2f(WINDOW_WIDTH - 55.0f, ROWS * CELL_SIZE + 25.0f));
-    window.draw(timeText);
+    if (!timeText)
+    {
+        timeText.emplace(font, "", 24);
+        timeText->setStyle(sf::Text::Bold);
+        timeText->setFillColor(sf::Color::White);
+        timeText->setPosition(sf::Vector2f(WINDOW_WIDTH - 55.0f, ROWS * CELL_SIZE + 25.0f));
+    }
+    if (seconds != shownSeconds)
+    {
+        shownSeconds = seconds;
+        timeText->setString(std::to_string(seconds));
+        sf::FloatRect bounds = timeText->getLocalBounds();
+        timeText->setOrigin(sf::Vector2f(bounds.position.x + bounds.size.x / 2.0f,
+                                         bounds.position.y + bounds.size.y / 2.0f));
+    }
+    window.draw(*timeText);
 }
 
 /**
@@ -304,16 +536,8 @@ void drawExitButton(sf::RenderWindow& window, const sf::Font& font) {
     window.draw(button);
 
     // --- 3. Draw "X" Text ---
-    sf::Text exitText(font, "X");
-    exitText.setCharacterSize(22);
+    sf::Text& exitText = getCachedText(font, "X", 22, sf::Text::Bold);
     exitText.setFillColor(sf::Color::White);
-    exitText.setStyle(sf::Text::Bold);
-    
-    sf::FloatRect textBounds = exitText.getLocalBounds();
-    exitText.setOrigin(sf::Vector2f(
-        textBounds.position.x + textBounds.size.x / 2.0f,
-        textBounds.position.y + textBounds.size.y / 2.0f
-    ));
     
     // Position text in the center of the button
     exitText.setPosition(sf::Vector2f(buttonX + buttonWidth / 2.0f, buttonY + buttonHeight / 2.0f));
@@ -332,24 +556,214 @@ bool isClickOnGameExitButton(float x, float y) {
             y >= g_exitButtonY - margin && y <= g_exitButtonY + g_exitButtonHeight + margin);
 }
 
+/**
+ * @brief Checks whether the computer opponent should move now
+ */
+bool isCPUTurn()
+{
+    return (g_headless || (g_player2IsCPU && currentPlayer == 2)) && !gameOver;
+}
+
+/**
+ * @brief Chooses the computer's column for the current player.
+ *        Headless games use a single-threaded, node-limited search (after a
+ *        few seeded random plies) so they replay identically on any machine.
+ */
+int pickCPUMove()
+{
+    if (!g_headless)
+        return chooseAIMove(g_board, currentPlayer);
+
+    if (g_board.moves < HEADLESS_RANDOM_PLIES)
+        return randomLegalColumn(g_board, g_headlessRng);
+    return searchBestMove(g_board, currentPlayer, {AI_MAX_DEPTH, AI_NODE_LIMIT}).column;
+}
+
+/**
+ * @brief Whether the current player's clock has run out
+ */
+bool isTurnTimedOut()
+{
+    return timerActive && !gameOver && currentTurnTicks >= TURN_TICK_LIMIT;
+}
+
+/**
+ * @brief Drives the search for a human whose clock ran out (window only).
+ *        A search already on this exact position (pondering with no
+ *        prediction) has thought for the whole turn and answers at once;
+ *        any other ponder search is stopped so only one search uses the cores.
+ * @return Column to play now, or -1 while the search is still thinking
+ */
+int updateTimeoutMove()
+{
+    if (g_mctsFallback)
+    {
+        if (g_mctsMove.valid())
+        {
+            if (g_mctsMove.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+                return -1;
+            MCTSResult result = g_mctsMove.get();
+            if (g_mctsMovePosition == g_board.key())
+                return result.column;
+            // Searched for a turn the player finished by hand; search this one
+        }
+        g_cpuSearch.stop();
+        g_mctsMovePosition = g_board.key();
+        g_mctsMove = std::async(std::launch::async, [board = g_board, player = currentPlayer] {
+            TRACE_THREAD_NAME("mcts_timeout");
+            return g_mcts.search(board, player, {TIMEOUT_MOVE_TIME, 0, hardwareThreads()});
+        });
+        return -1;
+    }
+
+    if (g_cpuSearch.isActive() && g_cpuSearch.getBoard().key() == g_board.key())
+    {
+        if (!g_cpuSearch.isFinished() && g_cpuSearch.elapsedSeconds() < TIMEOUT_MOVE_TIME)
+            return -1;
+        AnytimeMove move = g_cpuSearch.stop();
+        if (move.column >= 0)
+            return move.column;
+    }
+    g_cpuSearch.stop(); // Pondering the computer's reply; the human's move comes first
+
+    int bookColumn = probeBookMove(g_board, currentPlayer);
+    if (bookColumn >= 0)
+        return bookColumn;
+    g_cpuSearch.start(g_board, currentPlayer, TIMEOUT_MOVE_TIME, hardwareThreads());
+    return -1;
+}
+
+/**
+ * @brief Waits for an MCTS timeout move still being searched and drops it
+ *        (it takes at most TIMEOUT_MOVE_TIME)
+ */
+void cancelTimeoutMove()
+{
+    if (g_mctsMove.valid())
+        g_mctsMove.get();
+}
+
+/**
+ * @brief Drives the computer's anytime search for the current turn (window only).
+ *        A ponder search on this exact position carries on with a full turn's
+ *        budget counted from when it started; otherwise a new search gets the
+ *        turn's remaining time. The best move is played once the search
+ *        finishes, its budget is spent, or only CPU_TURN_MARGIN is left.
+ * @return Column to play now, or -1 while the search is still thinking
+ */
+int updateCPUSearch()
+{
+    if (g_cpuSearch.isActive() && g_cpuSearch.getBoard().key() != g_board.key())
+    {
+        g_cpuSearch.stop(); // Pondered the wrong reply; its table entries stay useful
+    }
+
+    if (!g_cpuSearch.isActive())
+    {
+        int bookColumn = probeBookMove(g_board, currentPlayer);
+        if (bookColumn >= 0)
+            return bookColumn;
+        g_cpuThinkBudget = std::max(getTurnTimeRemaining() - CPU_TURN_MARGIN, static_cast<float>(AI_MOVE_TIME));
+        g_cpuSearch.start(g_board, currentPlayer, g_cpuThinkBudget, hardwareThreads());
+        return -1;
+    }
+
+    if (!g_cpuSearch.isFinished() && g_cpuSearch.elapsedSeconds() < g_cpuThinkBudget &&
+        getTurnTimeRemaining() > CPU_TURN_MARGIN)
+        return -1;
+    AnytimeMove move = g_cpuSearch.stop();
+    return move.column >= 0 ? move.column : chooseAIMove(g_board, currentPlayer);
+}
+
+/**
+ * @brief Starts searching on the human's time (window, against the computer only).
+ *        The reply the table expects is played on a copy of the board and the
+ *        computer's answer to it is searched without a time limit; with no
+ *        expectation yet, the human's own position is searched to warm the table.
+ */
+void startPondering()
+{
+    Board expected = g_board;
+    int reply = predictMove(g_board, currentPlayer);
+    if (reply >= 0)
+    {
+        expected.drop(reply, currentPlayer);
+        if (expected.winner != 0 || expected.isFull())
+            expected = g_board; // Nothing left for the computer to answer
+    }
+    g_cpuThinkBudget = TURN_TIME_LIMIT - CPU_TURN_MARGIN;
+    g_cpuSearch.start(expected, 1 + (expected.moves & 1), 0.0, hardwareThreads());
+}
+
+/**
+ * @brief Seconds left on the turn timer, derived from the step count.
+ */
+float getTurnTimeRemaining()
+{
+    int ticksLeft = TURN_TICK_LIMIT - currentTurnTicks;
+    return ticksLeft > 0 ? static_cast<float>(ticksLeft) / SIM_TICKS_PER_SECOND : 0.0f;
+}
+
+/**
+ * @brief Decides whether the next frame has to be rendered right away.
+ */
+RedrawMode getRedrawMode()
+{
+    if (currentState == LOADING)
+        return REDRAW_CONTINUOUS; // Poll the loader every frame
+
+    if (isProfilerOverlayVisible())
+        return REDRAW_CONTINUOUS; // Keep the frame-time graph live
+
+    if (currentState != PLAYING)
+        return REDRAW_ON_EVENT;
+
+    if (g_showAnalysis && isAnalysisRunning())
+        return REDRAW_CONTINUOUS; // Pick up deeper results as they arrive
+
+    bool popupFading = g_popup.isActive && g_popup.alpha < 255.0f;
+    if (isAnimationActive() || popupFading || isCPUTurn())
+        return REDRAW_CONTINUOUS;
+
+    if (timerActive && !gameOver)
+        return REDRAW_ON_TICK;
+
+    return REDRAW_ON_EVENT;
+}
+
+/**
+ * @brief Seconds until the displayed timer digit changes (or the turn times out).
+ */
+float getTimeUntilTimerTick()
+{
+    float timeRemaining = getTurnTimeRemaining();
+    if (timeRemaining <= 0.0f)
+        return 0.0f;
+
+    // The digit shows ceil(timeRemaining); wait until it drops by one
+    float untilTick = timeRemaining - (std::ceil(timeRemaining) - 1.0f);
+    return untilTick + 0.001f; // Land just past the boundary
+}
+
 /**
  * @brief Draws the game status using sprite graphics at the bottom of the window.
  */
 void drawStatus(sf::RenderWindow &window, const sf::Font &font)
 {
-    if (!g_uiTexture)
+    const AtlasRegion *uiImage = getAtlasRegion(ATLAS_UI);
+    if (!uiImage)
         return; // Safety check
 
     // Draw the current player's turn indicator sprite
-    sf::Sprite turnSprite(*g_uiTexture);
+    sf::Sprite turnSprite(*uiImage->texture);
 
     if (currentPlayer == 1)
     {
-        turnSprite.setTextureRect(PLAYER1_TURN_RECT);
+        turnSprite.setTextureRect(uiImage->rect(PLAYER1_TURN_RECT));
     }
     else
     {
-        turnSprite.setTextureRect(PLAYER2_TURN_RECT);
+        turnSprite.setTextureRect(uiImage->rect(PLAYER2_TURN_RECT));
     }
 
     // Scale sprite to fit status bar (adjust scale as needed)
@@ -367,290 +781,529 @@ void drawStatus(sf::RenderWindow &window, const sf::Font &font)
 }
 
 /**
- * @brief Main function where the SFML game loop resides.
+ * @brief Plays a move for the current player: the board changes at once and
+ *        the piece starts falling, so the next move does not have to wait.
+ * @param col Column to drop into (must be playable)
  */
-int main()
+void playMove(int col)
 {
-    // SFML 3.x Fix: VideoMode constructor now takes sf::Vector2u for size
-    sf::RenderWindow window(sf::VideoMode(sf::Vector2u(WINDOW_WIDTH, WINDOW_HEIGHT)), "Connect Four (C++/SFML)", sf::Style::Close);
-    window.setFramerateLimit(60);
+    int player = currentPlayer;
+    int row = dropPiece(g_board, col, player);
+    startDropAnimation(col, row, player);
+    g_record.addMove(col);
+
+    // Check win condition
+    if (checkWin(g_board, row, col))
+    {
+        gameOver = true;
+        statusText = (player == 1 ? "Player 1 (Red) WINS!" : "Player 2 (Yellow) WINS!");
+        timerActive = false;
+        g_winningCells = winningCells(g_board, row, col);
+        g_record.result = (player == 1) ? RESULT_RED_WINS : RESULT_YELLOW_WINS;
+        archiveGame();
+    }
+    else if (checkDraw(g_board))
+    {
+        gameOver = true;
+        statusText = "Game Over - It's a DRAW!";
+        timerActive = false;
+        g_record.result = RESULT_DRAW;
+        archiveGame();
+    }
+    else
+    {
+        // Switch player and update status
+        currentPlayer = (currentPlayer == 1) ? 2 : 1;
+        statusText = (currentPlayer == 1 ? "Player 1 (Red)'s Turn" : "Player 2 (Yellow)'s Turn");
+        // Reset timer for new turn
+        currentTurnTicks = 0;
+        timerActive = true;
+    }
+}
+
+/**
+ * @brief Shows the game over popup and flashes the winning line
+ *        (once the last piece has landed).
+ */
+void showGameOver()
+{
+    if (g_record.result == RESULT_DRAW)
+    {
+        initPopup(0, true);
+        return;
+    }
+
+    int winner = (g_record.result == RESULT_RED_WINS) ? 1 : 2;
+    initPopup(winner, false);
+    for (std::uint64_t cells = g_winningCells; cells; cells &= cells - 1)
+    {
+        int bit = __builtin_ctzll(cells);
+        startFlashAnimation(ROWS - 1 - bit % COLUMN_BITS, bit / COLUMN_BITS, winner);
+    }
+}
+
+/**
+ * @brief Advances the game by one fixed simulation step (SIM_TIMESTEP seconds).
+ */
+void updateGame()
+{
+    // Only update game logic when in PLAYING state
+    if (currentState != PLAYING)
+        return;
+
+    // Falling pieces and win flashes
+    {
+        ScopedPhaseTimer animationsTimer(PHASE_ANIMATIONS);
+        updateAnimations(SIM_TIMESTEP);
+    }
+
+    // Rules, turn timer and computer moves
+    {
+        ScopedPhaseTimer logicTimer(PHASE_GAME_LOGIC);
+
+        // The result is shown once the final piece has landed
+        if (gameOver && !g_popup.isActive && getActiveDropCount() == 0)
+        {
+            showGameOver();
+        }
+
+        // Update turn timer
+        if (timerActive && !gameOver)
+        {
+            ++currentTurnTicks;
+
+            // Check for timeout: let the AI play the move the player ran out of time for
+            if (isTurnTimedOut() && !(g_player2IsCPU && currentPlayer == 2))
+            {
+                int aiCol = g_headless ? pickCPUMove() : updateTimeoutMove();
+                if (g_board.canPlay(aiCol))
+                {
+                    playMove(aiCol);
+                }
+            }
+        }
+
+        // Computer opponent moves once the previous piece has landed
+        if (isCPUTurn() && getActiveDropCount() == 0)
+        {
+            int aiCol = g_headless ? pickCPUMove() : updateCPUSearch();
+            if (g_board.canPlay(aiCol))
+            {
+                playMove(aiCol);
+            }
+        }
+        else if (g_cpuSearch.isActive() && (gameOver || (!g_player2IsCPU && !isTurnTimedOut())))
+        {
+            g_cpuSearch.stop(); // Player 2 was handed back to a human, or the game ended
+        }
+        else if (!g_headless && g_player2IsCPU && !gameOver && !isCPUTurn() && !g_cpuSearch.isActive())
+        {
+            startPondering(); // Human's turn: think about the reply meanwhile
+        }
+    }
+
+    // Update popup fade-in animation
+    ScopedPhaseTimer popupTimer(PHASE_POPUP);
+    updatePopup(SIM_TIMESTEP);
+}
 
-    // Load sprite textures
-    g_uiTexture = std::make_unique<sf::Texture>();
-    // SFML 3.x Fix: Texture loading uses loadFromFile
-    if (!g_uiTexture->loadFromFile("assets/ui_sprites.jpg"))
+/**
+ * @brief Runs as many fixed steps as the accumulated time allows.
+ * @param accumulator Unsimulated time in seconds; the remainder is left in it
+ */
+void advanceSimulation(float &accumulator)
+{
+    while (accumulator >= SIM_TIMESTEP)
     {
-        std::cerr << "--- SPRITE ERROR ---" << std::endl;
-        std::cerr << "Failed to load UI sprite sheet from assets/ui_sprites.jpg" << std::endl;
-        std::cerr << "Make sure the assets directory exists in the game folder." << std::endl;
-        return 1;
+        updateGame();
+        accumulator -= SIM_TIMESTEP;
     }
+}
+
+/**
+ * @brief Writes the timeline to TRACE_DEFAULT_PATH when tracing is compiled in (make TRACE=1).
+ */
+void writeTraceFile()
+{
+    if (!TRACE_ENABLED)
+        return;
+    if (writeTrace(TRACE_DEFAULT_PATH))
+        std::cout << "Trace written to " << TRACE_DEFAULT_PATH << std::endl;
+    else
+        std::cout << "Cannot write " << TRACE_DEFAULT_PATH << std::endl;
+}
 
-    // Load draw sprite
-    g_drawTexture = std::make_unique<sf::Texture>();
-    if (!g_drawTexture->loadFromFile("assets/draw_sprite.png"))
+/**
+ * @brief Plays CPU vs CPU games through the fixed-step simulation without a window.
+ *        Steps run back to back instead of waiting for real time, and the
+ *        summary checksum lets runs on different machines be compared.
+ * @param games Number of games to play
+ * @param seed Seed for the random opening plies
+ * @return Process exit code
+ */
+int runHeadless(int games, std::uint64_t seed)
+{
+    g_headless = true;
+    g_headlessRng = seed | 1;
+    int results[3] = {0, 0, 0}; // Draws, Red wins, Yellow wins
+    std::uint64_t totalTicks = 0;
+    std::uint64_t checksum = 0xCBF29CE484222325ull; // FNV-1a over every move and game length
+
+    sf::Clock wallClock;
+    for (int game = 0; game < games; ++game)
     {
-        std::cerr << "--- WARNING ---" << std::endl;
-        std::cerr << "Failed to load draw sprite from assets/draw_sprite.png" << std::endl;
-        std::cerr << "Game will continue but draw sprite won't display." << std::endl;
-        g_drawTexture = nullptr; // Set to nullptr so popup knows to use fallback
+        TRACE_SCOPE("headless_game");
+        clearAITable(); // Each game starts from the same search state
+        resetGame();
+        currentState = PLAYING;
+
+        std::uint64_t ticks = 0;
+        while (!gameOver)
+        {
+            updateGame();
+            ++ticks;
+        }
+
+        int winner = g_board.hasWon(1) ? 1 : (g_board.hasWon(2) ? 2 : 0);
+        ++results[winner];
+        totalTicks += ticks;
+        for (int ply = 0; ply < g_record.plies; ++ply)
+        {
+            checksum = (checksum ^ g_record.moves[ply]) * 0x100000001B3ull;
+        }
+        checksum = (checksum ^ ticks) * 0x100000001B3ull;
     }
+    float wallSeconds = wallClock.getElapsedTime().asSeconds();
+    float simulatedSeconds = totalTicks * SIM_TIMESTEP;
+
+    std::cout << "Headless: " << games << " games | red " << results[1] << " | yellow " << results[2]
+              << " | draw " << results[0] << std::endl;
+    std::cout << "Simulated " << simulatedSeconds << " s in " << wallSeconds << " s ("
+              << (wallSeconds > 0.0f ? simulatedSeconds / wallSeconds : 0.0f) << "x real time)" << std::endl;
+    std::cout << "Checksum " << std::hex << checksum << std::dec << std::endl;
+    writeTraceFile();
+    return 0;
+}
 
-    // Load start screen sprite
-    g_startTexture = std::make_unique<sf::Texture>();
-    if (!g_startTexture->loadFromFile("assets/start_screen.png"))
+/**
+ * @brief Main function where the SFML game loop resides.
+ */
+int main(int argc, char *argv[])
+{
+    // Optional command-line flags: play against the computer, pick the
+    // timeout fallback, or run computer-only games without a window
+    bool headless = false;
+    int headlessGames = 10;
+    std::uint64_t headlessSeed = 1;
+    for (int i = 1; i < argc; ++i)
     {
-        std::cerr << "--- WARNING ---" << std::endl;
-        std::cerr << "Failed to load start screen from assets/start_screen.png" << std::endl;
-        std::cerr << "Game will continue but start screen won't display." << std::endl;
-        g_startTexture = nullptr;
+        if (std::strcmp(argv[i], "--cpu") == 0)
+        {
+            g_player2IsCPU = true;
+        }
+        else if (std::strcmp(argv[i], "--mcts") == 0)
+        {
+            g_mctsFallback = true;
+        }
+        else if (std::strcmp(argv[i], "--headless") == 0)
+        {
+            headless = true;
+        }
+        else if (std::strcmp(argv[i], "--games") == 0 && i + 1 < argc)
+        {
+            headlessGames = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+        {
+            headlessSeed = std::strtoull(argv[++i], nullptr, 10);
+        }
     }
 
-    // --- In connect4_sfml.cpp (inside int main()) ---
-    // ...
-    // Load a font for displaying text (still needed for popup)
-    sf::Font font;
-    bool fontLoaded = false;
+    TRACE_THREAD_NAME("main");
 
-    // 1. Try loading the bundled font asset first (Recommended for Windows/Linux)
-    if (font.openFromFile("assets/Arial.ttf"))
+    if (headless)
     {
-        fontLoaded = true;
+        return runHeadless(headlessGames, headlessSeed);
     }
-    // 2. Fallback to Mac-specific paths (Only for compatibility with friend's setup)
-    else if (font.openFromFile("/System/Library/Fonts/Helvetica.ttc"))
+
+    // SFML 3.x Fix: VideoMode constructor now takes sf::Vector2u for size
+    sf::RenderWindow window(sf::VideoMode(sf::Vector2u(WINDOW_WIDTH, WINDOW_HEIGHT)), "Connect Four (C++/SFML)", sf::Style::Close);
+    window.setFramerateLimit(60);
+
+    // Decode sprites and the font off the main thread; a placeholder
+    // screen is drawn until they are ready
+    startAssetLoading();
+    const sf::Font &font = getGameFont();
+
+    // Allocate the AI transposition table up front so the first CPU move stays fast
+    clearAITable();
+
+    // Map the precomputed opening book (optional, generated with `make book`)
+    if (!openOpeningBook(OPENING_BOOK_PATH))
     {
-        fontLoaded = true;
+        std::cout << "No opening book at " << OPENING_BOOK_PATH << ", AI will search every move." << std::endl;
     }
-    else if (font.openFromFile("/System/Library/Fonts/Supplemental/Arial.ttf"))
+
+    // Positions solved in earlier sessions are answered without searching
+    if (!openSolvedCache(SOLVED_CACHE_PATH))
     {
-        fontLoaded = true;
+        std::cout << "Cannot open " << SOLVED_CACHE_PATH << ".log, solved positions will not be kept." << std::endl;
     }
 
-    if (!fontLoaded)
+    // Append played games to the archive (check with `make replay`)
+    if (!g_recordWriter.open(GAME_RECORD_PATH))
     {
-        std::cerr << "--- FONT ERROR ---" << std::endl;
-        std::cerr << "FATAL: Failed to load any font. Text (Timer/Popup) will not display." << std::endl;
-        // Note: The program can continue, but text will be missing.
+        std::cout << "Cannot open " << GAME_RECORD_PATH << ", games will not be recorded." << std::endl;
     }
-    // ... rest of the main loop
 
     // Main game loop
-    sf::Clock clock; // For tracking deltaTime
+    sf::Clock clock;          // For tracking frame time
+    float accumulator = 0.0f; // Real time not yet simulated
+    bool needsRedraw = true;  // Something visible changed since the last frame
 
     while (window.isOpen())
     {
-        float deltaTime = clock.restart().asSeconds(); // Time since last frame
-
-        // SFML 3.x Event handling loop: pollEvent now returns an optional event object
-        // NOTE: std::optional is required, which is why we need the C++17 flag.
-        for (std::optional<sf::Event> eventOpt = window.pollEvent(); eventOpt.has_value(); eventOpt = window.pollEvent())
+        beginProfilerFrame();
+
+        // Block instead of spinning when nothing on screen can change by itself.
+        // Time spent blocked is simulated before the waking event is handled,
+        // so a piece dropped right after waking does not jump ahead.
+        std::optional<sf::Event> pendingEvent;
+        RedrawMode redrawMode = getRedrawMode();
+        if (!needsRedraw && redrawMode != REDRAW_CONTINUOUS)
         {
-            const auto &event = eventOpt.value(); // Access the event structure
-
-            if (event.is<sf::Event::Closed>())
+            clock.restart();
+            {
+                ScopedPhaseTimer idleTimer(PHASE_IDLE);
+                if (redrawMode == REDRAW_ON_TICK)
+                    pendingEvent = window.waitEvent(sf::seconds(getTimeUntilTimerTick()));
+                else
+                    pendingEvent = window.waitEvent(); // No timeout: wait for input
+            }
+            float blockedTime = clock.restart().asSeconds();
+            if (redrawMode == REDRAW_ON_TICK)
             {
-                window.close();
+                // Only the turn timer was running
+                accumulator += blockedTime;
+                advanceSimulation(accumulator);
             }
+            needsRedraw = true; // Woken by input or by a timer tick
+        }
 
-            // Handle mouse clicks
-            if (const auto *mouseEvent = event.getIf<sf::Event::MouseButtonPressed>())
+        // Time since last frame, clamped so a stall does not queue up many steps
+        float frameTime = std::min(clock.restart().asSeconds(), MAX_FRAME_TIME);
+
+        {
+            ScopedPhaseTimer eventsTimer(PHASE_EVENTS);
+
+            // SFML 3.x Event handling loop: pollEvent now returns an optional event object
+            // NOTE: std::optional is required, which is why we need the C++17 flag.
+            for (std::optional<sf::Event> eventOpt = pendingEvent ? std::move(pendingEvent) : window.pollEvent();
+                 eventOpt.has_value(); eventOpt = window.pollEvent())
             {
-                if (mouseEvent->button == sf::Mouse::Button::Left)
+                const auto &event = eventOpt.value(); // Access the event structure
+
+                // Mouse movement alone never changes what is drawn
+                if (!event.is<sf::Event::MouseMoved>())
                 {
-                    float mouseX = static_cast<float>(mouseEvent->position.x);
-                    float mouseY = static_cast<float>(mouseEvent->position.y);
+                    needsRedraw = true;
+                }
 
-                    // Handle clicks on start screen
-                    if (currentState == START_SCREEN)
-                    {
-                        if (isClickOnStartButton(mouseX, mouseY))
-                        {
-                            currentState = PLAYING;
-                            timerActive = true;
-                        }
-                        else if (isClickOnExitButton(mouseX, mouseY))
-                        {
-                            window.close();
-                        }
-                    }
-                    // Handle clicks during gameplay
-                    else if (currentState == PLAYING)
+                if (event.is<sf::Event::Closed>())
+                {
+                    window.close();
+                }
+
+                // Handle mouse clicks
+                if (const auto *mouseEvent = event.getIf<sf::Event::MouseButtonPressed>())
+                {
+                    if (mouseEvent->button == sf::Mouse::Button::Left)
                     {
-                        // Check if clicking exit button to return to start screen
-                        if (isClickOnGameExitButton(mouseX, mouseY))
-                        {
-                            // Return to start screen
-                            currentState = START_SCREEN;
-                            resetGame();
-                        }
-                        // Check if clicking restart button in game over popup
-                        else if (gameOver && isClickOnRestartButton(mouseX, mouseY))
+                        float mouseX = static_cast<float>(mouseEvent->position.x);
+                        float mouseY = static_cast<float>(mouseEvent->position.y);
+
+                        // Handle clicks on start screen
+                        if (currentState == START_SCREEN)
                         {
-                            resetGame();
+                            if (isClickOnStartButton(mouseX, mouseY))
+                            {
+                                currentState = PLAYING;
+                                timerActive = true;
+                            }
+                            else if (isClickOnExitButton(mouseX, mouseY))
+                            {
+                                window.close();
+                            }
                         }
-                        // Normal piece placement
-                        else if (!gameOver && !isAnimationActive())
+                        // Handle clicks during gameplay
+                        else if (currentState == PLAYING)
                         {
-                            // Calculate which column was clicked using the mouse position
-                            int clickedCol = static_cast<int>(mouseX / CELL_SIZE);
-
-                            // Find the target row for animation
-                            int targetRow = -1;
-                            for (int r = ROWS - 1; r >= 0; --r)
+                            // Check if clicking exit button to return to start screen
+                            if (isClickOnGameExitButton(mouseX, mouseY))
                             {
-                                if (board[r][clickedCol] == 0)
-                                {
-                                    targetRow = r;
-                                    break;
-                                }
+                                // Return to start screen
+                                currentState = START_SCREEN;
+                                resetGame();
                             }
-
-                            if (targetRow != -1)
+                            // Check if clicking restart button in game over popup
+                            else if (gameOver && isClickOnRestartButton(mouseX, mouseY))
                             {
-                                // Start the fall animation
-                                initAnimation(clickedCol, targetRow, currentPlayer);
+                                resetGame();
                             }
-                            else
+                            // Normal piece placement (earlier pieces may still be falling)
+                            else if (!gameOver && !isCPUTurn())
                             {
-                                std::cout << "Column " << clickedCol + 1 << " is full!" << std::endl;
+                                // Calculate which column was clicked using the mouse position
+                                int clickedCol = static_cast<int>(mouseX / CELL_SIZE);
+
+                                if (g_board.canPlay(clickedCol))
+                                {
+                                    playMove(clickedCol);
+                                }
+                                else
+                                {
+                                    std::cout << "Column " << clickedCol + 1 << " is full!" << std::endl;
+                                }
                             }
                         }
                     }
                 }
-            }
-
-            // Handle keyboard input for restarting the game
-            if (const auto *keyEvent = event.getIf<sf::Event::KeyPressed>())
-            {
-                if (keyEvent->code == sf::Keyboard::Key::R)
-                {
-                    resetGame();
-                }
-            }
-        }
-
-        // Only update game logic when in PLAYING state
-        if (currentState == PLAYING)
-        {
-            // Update animation if active
-            if (isAnimationActive())
-            {
-                updateAnimation(deltaTime);
 
-                // Check if animation just finished
-                if (!isAnimationActive())
+                // Handle keyboard input for restarting the game
+                if (const auto *keyEvent = event.getIf<sf::Event::KeyPressed>())
                 {
-                    // Animation complete - place the piece on board
-                    int col = g_animation.column;
-                    int row = g_animation.targetRow;
-                    int player = g_animation.player;
-
-                    board[row][col] = player;
-
-                    // Check win condition
-                    if (checkWin(row, col))
+                    if (keyEvent->code == sf::Keyboard::Key::R)
                     {
-                        gameOver = true;
-                        statusText = (player == 1 ? "Player 1 (Red) WINS!" : "Player 2 (Yellow) WINS!");
-                        initPopup(player, false);
-                        timerActive = false;
+                        resetGame();
                     }
-                    else if (checkDraw())
+                    // Toggle the computer opponent for Player 2
+                    else if (keyEvent->code == sf::Keyboard::Key::C)
                     {
-                        gameOver = true;
-                        statusText = "Game Over - It's a DRAW!";
-                        initPopup(0, true);
-                        timerActive = false;
+                        g_player2IsCPU = !g_player2IsCPU;
+                        std::cout << "Player 2 is now " << (g_player2IsCPU ? "the computer" : "human") << std::endl;
                     }
-                    else
+                    // Per-column analysis overlay (the worker stops while it is hidden)
+                    else if (keyEvent->code == sf::Keyboard::Key::A)
                     {
-                        // Switch player and update status
-                        currentPlayer = (currentPlayer == 1) ? 2 : 1;
-                        statusText = (currentPlayer == 1 ? "Player 1 (Red)'s Turn" : "Player 2 (Yellow)'s Turn");
-                        // Reset timer for new turn
-                        currentTurnTime = 0.0f;
-                        timerActive = true;
+                        g_showAnalysis = !g_showAnalysis;
+                        g_analysisPosition = NO_POSITION;
+                        if (!g_showAnalysis)
+                            stopAnalysis();
                     }
-                }
-            }
-
-            // Update turn timer
-            if (timerActive && !gameOver && !isAnimationActive())
-            {
-                currentTurnTime += deltaTime;
-
-                // Check for timeout
-                if (currentTurnTime >= TURN_TIME_LIMIT)
-                {
-                    // Find a random valid column
-                    std::vector<int> validCols;
-                    for (int c = 0; c < COLS; ++c)
+                    // Frame-time profiler: overlay and CSV export of the recorded frames.
+                    // Ignored while loading: the overlay needs the font the loader is still writing.
+                    else if (keyEvent->code == sf::Keyboard::Key::F3 && currentState != LOADING)
                     {
-                        if (board[0][c] == 0)
-                        {
-                            validCols.push_back(c);
-                        }
+                        toggleProfilerOverlay();
                     }
-
-                    if (!validCols.empty())
+                    else if (keyEvent->code == sf::Keyboard::Key::F4 && currentState != LOADING)
                     {
-                        // Pick random column
-                        int randomCol = validCols[rand() % validCols.size()];
-
-                        // Find target row
-                        int targetRow = -1;
-                        for (int r = ROWS - 1; r >= 0; --r)
-                        {
-                            if (board[r][randomCol] == 0)
-                            {
-                                targetRow = r;
-                                break;
-                            }
-                        }
-
-                        if (targetRow != -1)
-                        {
-                            // Auto-place piece with animation
-                            initAnimation(randomCol, targetRow, currentPlayer);
-                            timerActive = false; // Stop timer during animation
-                        }
+                        if (exportProfilerCSV(PROFILER_CSV_PATH))
+                            std::cout << "Frame profile written to " << PROFILER_CSV_PATH << std::endl;
+                        else
+                            std::cout << "Cannot write " << PROFILER_CSV_PATH << std::endl;
                     }
                 }
             }
+        }
 
-            // Update popup fade-in animation
-            updatePopup(deltaTime);
+        // Switch to the start screen as soon as the assets are ready
+        if (currentState == LOADING && updateAssetLoading())
+        {
+            if (!getAtlasRegion(ATLAS_UI))
+            {
+                std::cerr << "--- SPRITE ERROR ---" << std::endl;
+                std::cerr << "Failed to load UI sprite sheet from assets/ui_sprites.jpg" << std::endl;
+                std::cerr << "Make sure the assets directory exists in the game folder." << std::endl;
+                return 1;
+            }
+            if (!isGameFontLoaded())
+            {
+                std::cerr << "--- FONT ERROR ---" << std::endl;
+                std::cerr << "FATAL: Failed to load any font. Text (Timer/Popup) will not display." << std::endl;
+                // Note: The program can continue, but text will be missing.
+            }
+            currentState = START_SCREEN;
+            needsRedraw = true;
         }
 
+        // Advance the simulation in fixed steps; the remainder is used to
+        // interpolate the falling piece between the last two steps
+        accumulator += frameTime;
+        advanceSimulation(accumulator);
+        float interpolation = accumulator / SIM_TIMESTEP;
+
+        if (refreshAnalysis())
+            needsRedraw = true;
+
         // --- Drawing ---
+        // Skip the frame entirely when nothing changed and nothing is moving.
+        // A frame that started in continuous mode is always drawn so the
+        // final state of a finished animation or fade reaches the screen.
+        if (!needsRedraw && redrawMode != REDRAW_CONTINUOUS && getRedrawMode() != REDRAW_CONTINUOUS)
+        {
+            continue;
+        }
+        needsRedraw = false;
+
         window.clear(sf::Color(50, 50, 50));
 
-        if (currentState == START_SCREEN)
+        if (currentState == LOADING)
+        {
+            drawLoadingScreen(window, getAssetLoadingProgress());
+        }
+        else if (currentState == START_SCREEN)
         {
             // Draw start screen
-            drawStartScreen(window, g_startTexture.get());
+            drawStartScreen(window, getAtlasRegion(ATLAS_START));
         }
         else if (currentState == PLAYING)
         {
             // Draw game
-            drawBoard(window);
-            drawStatus(window, font);
-            drawTimer(window, font);
-            drawExitButton(window, font); // Draw exit button to return to start screen
+            {
+                ScopedPhaseTimer boardTimer(PHASE_DRAW_BOARD);
+                drawBoard(window, font);
+            }
+            {
+                ScopedPhaseTimer hudTimer(PHASE_DRAW_HUD);
+                drawStatus(window, font);
+                drawTimer(window, font);
+                drawExitButton(window, font); // Draw exit button to return to start screen
+            }
 
-            // Draw falling piece on top of board
-            drawFallingPiece(window);
+            // Draw falling pieces and win flashes on top of board
+            {
+                ScopedPhaseTimer animationsTimer(PHASE_DRAW_ANIMATIONS);
+                drawAnimations(window, interpolation);
+            }
 
             // Draw winner popup if game is over
             if (gameOver)
             {
-                drawWinnerPopup(window, font, g_uiTexture.get(), g_drawTexture.get());
+                ScopedPhaseTimer popupTimer(PHASE_DRAW_POPUP);
+                drawWinnerPopup(window, font, getAtlasRegion(ATLAS_UI), getAtlasRegion(ATLAS_DRAW));
             }
         }
 
-        window.display();
+        // The overlay's text uses the game font, which is ready only after loading
+        if (currentState != LOADING)
+        {
+            drawProfilerOverlay(window, font);
+        }
+
+        {
+            ScopedPhaseTimer displayTimer(PHASE_DISPLAY);
+            window.display();
+        }
     }
 
+    // Keep the game in progress, then flush the archive
+    resetGame();
+    g_recordWriter.close();
+    g_cpuSearch.stop();
+    stopAnalysis();
+    closeSolvedCache(); // After the searches: compacts the log into the index
+    shutdownAssetLoading();
+    writeTraceFile();
     return 0;
 }
\ No newline at end of file
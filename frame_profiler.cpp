@@ -0,0 +1,171 @@
+#include "frame_profiler.h"
+#include "trace.h"
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+namespace {
+
+using ProfileClock = std::chrono::steady_clock;
+
+constexpr const char* PHASE_NAMES[PHASE_COUNT] = {
+    "idle", "events", "animations", "game_logic", "popup",
+    "draw_board", "draw_hud", "draw_animations", "draw_popup", "display"};
+
+constexpr float OVERLAY_REFRESH_SECONDS = 0.25f; // Percentiles are recomputed this often
+constexpr float GRAPH_HEIGHT = 80.0f;
+constexpr float GRAPH_MAX_MS = 50.0f;             // Frame time at the top of the graph
+constexpr float TARGET_FRAME_MS = 1000.0f / 60.0f;
+
+// Frame being measured (main thread only)
+FrameProfile g_current = {};
+ProfileClock::time_point g_frameStart;
+bool g_frameStarted = false;
+
+// History ring (main thread only): frame n lives in slot n % PROFILER_HISTORY
+FrameProfile g_history[PROFILER_HISTORY];
+std::uint64_t g_framesWritten = 0;
+
+// Overlay state
+bool g_overlayVisible = false;
+std::unique_ptr<sf::Text> g_overlayText;
+ProfileClock::time_point g_overlayRefreshed;
+FrameProfile g_snapshot[PROFILER_HISTORY];
+sf::Vertex g_graphVertices[PROFILER_HISTORY];
+
+float elapsedMs(ProfileClock::time_point since) {
+    return std::chrono::duration<float, std::milli>(ProfileClock::now() - since).count();
+}
+
+/**
+ * @brief Nearest-rank percentile (reorders values)
+ */
+float percentile(float* values, int count, float fraction) {
+    if (count == 0) return 0.0f;
+    int rank = std::min(count - 1, static_cast<int>(fraction * count));
+    std::nth_element(values, values + rank, values + count);
+    return values[rank];
+}
+
+/**
+ * @brief Rebuild the p50/p99 table from the frames in g_snapshot
+ *        (values are sorted in a scratch array, g_snapshot keeps frame order)
+ */
+void refreshOverlayText(int frames) {
+    static float values[PROFILER_HISTORY];
+    char line[96];
+    std::string table = "phase             p50 ms   p99 ms\n";
+
+    for (int phase = 0; phase <= PHASE_COUNT; ++phase) {
+        for (int i = 0; i < frames; ++i) {
+            values[i] = (phase == PHASE_COUNT) ? g_snapshot[i].frameMs : g_snapshot[i].phaseMs[phase];
+        }
+        float p50 = percentile(values, frames, 0.50f);
+        float p99 = percentile(values, frames, 0.99f);
+        std::snprintf(line, sizeof(line), "%-16s %7.2f  %7.2f\n",
+                      phase == PHASE_COUNT ? "frame" : PHASE_NAMES[phase], p50, p99);
+        table += line;
+    }
+    g_overlayText->setString(table);
+}
+
+} // namespace
+
+ScopedPhaseTimer::ScopedPhaseTimer(ProfilePhase phase) : phase(phase), start(ProfileClock::now()) {}
+
+ScopedPhaseTimer::~ScopedPhaseTimer() {
+    ProfileClock::time_point end = ProfileClock::now();
+    g_current.phaseMs[phase] += std::chrono::duration<float, std::milli>(end - start).count();
+    TRACE_EVENT(PHASE_NAMES[phase], start, end); // Main loop phases also appear on the trace timeline
+}
+
+void beginProfilerFrame() {
+    ProfileClock::time_point now = ProfileClock::now();
+    if (g_frameStarted) {
+        g_current.frameMs = std::chrono::duration<float, std::milli>(now - g_frameStart).count();
+        TRACE_EVENT("frame", g_frameStart, now);
+        g_history[g_framesWritten % PROFILER_HISTORY] = g_current;
+        ++g_framesWritten;
+    }
+    g_current = FrameProfile();
+    g_frameStart = now;
+    g_frameStarted = true;
+}
+
+int snapshotProfilerHistory(FrameProfile* out) {
+    std::uint64_t end = g_framesWritten;
+    std::uint64_t begin = end > PROFILER_HISTORY ? end - PROFILER_HISTORY : 0;
+    for (std::uint64_t i = begin; i < end; ++i) {
+        out[i - begin] = g_history[i % PROFILER_HISTORY];
+    }
+    return static_cast<int>(end - begin);
+}
+
+bool exportProfilerCSV(const char* path) {
+    static FrameProfile frames[PROFILER_HISTORY];
+    int count = snapshotProfilerHistory(frames);
+
+    std::FILE* file = std::fopen(path, "w");
+    if (!file) return false;
+    std::fprintf(file, "frame,frame_ms");
+    for (const char* name : PHASE_NAMES) std::fprintf(file, ",%s_ms", name);
+    std::fprintf(file, "\n");
+    for (int i = 0; i < count; ++i) {
+        std::fprintf(file, "%d,%.3f", i, frames[i].frameMs);
+        for (float ms : frames[i].phaseMs) std::fprintf(file, ",%.3f", ms);
+        std::fprintf(file, "\n");
+    }
+    return std::fclose(file) == 0;
+}
+
+void toggleProfilerOverlay() {
+    g_overlayVisible = !g_overlayVisible;
+}
+
+bool isProfilerOverlayVisible() {
+    return g_overlayVisible;
+}
+
+void drawProfilerOverlay(sf::RenderWindow& window, const sf::Font& font) {
+    if (!g_overlayVisible) return;
+
+    int frames = snapshotProfilerHistory(g_snapshot);
+    if (!g_overlayText) {
+        g_overlayText = std::make_unique<sf::Text>(font, "", 13);
+        g_overlayText->setFillColor(sf::Color::White);
+        g_overlayText->setPosition(sf::Vector2f(10.0f, 10.0f));
+        g_overlayRefreshed = ProfileClock::now() - std::chrono::seconds(1);
+    }
+    if (elapsedMs(g_overlayRefreshed) >= OVERLAY_REFRESH_SECONDS * 1000.0f) {
+        refreshOverlayText(frames);
+        g_overlayRefreshed = ProfileClock::now();
+    }
+
+    // Translucent panel behind the table and the graph
+    float width = static_cast<float>(window.getSize().x) - 20.0f;
+    sf::RectangleShape panel(sf::Vector2f(width, 190.0f + GRAPH_HEIGHT));
+    panel.setPosition(sf::Vector2f(5.0f, 5.0f));
+    panel.setFillColor(sf::Color(0, 0, 0, 180));
+    window.draw(panel);
+    window.draw(*g_overlayText);
+
+    // Frame-time graph, newest frame on the right, with a 60 FPS reference line
+    float graphBottom = 190.0f + GRAPH_HEIGHT;
+    float step = width / PROFILER_HISTORY;
+    for (int i = 0; i < frames; ++i) {
+        float ms = std::min(g_snapshot[i].frameMs, GRAPH_MAX_MS);
+        g_graphVertices[i].position = sf::Vector2f(10.0f + (PROFILER_HISTORY - frames + i) * step,
+                                                   graphBottom - ms / GRAPH_MAX_MS * GRAPH_HEIGHT);
+        g_graphVertices[i].color = ms > TARGET_FRAME_MS * 1.5f ? sf::Color::Red : sf::Color::Green;
+    }
+    float targetY = graphBottom - TARGET_FRAME_MS / GRAPH_MAX_MS * GRAPH_HEIGHT;
+    sf::Vertex target[2];
+    target[0].position = sf::Vector2f(10.0f, targetY);
+    target[1].position = sf::Vector2f(10.0f + width - 10.0f, targetY);
+    target[0].color = target[1].color = sf::Color(255, 255, 255, 120);
+    window.draw(target, 2, sf::PrimitiveType::Lines);
+    if (frames > 1) {
+        window.draw(g_graphVertices, frames, sf::PrimitiveType::LineStrip);
+    }
+}
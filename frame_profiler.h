@@ -0,0 +1,77 @@
+#ifndef FRAME_PROFILER_H
+#define FRAME_PROFILER_H
+
+#include <SFML/Graphics.hpp>
+#include <chrono>
+
+// Per-frame timing of the main loop phases. Scoped timers add their elapsed
+// time to the current frame; beginProfilerFrame() publishes the finished
+// frame into a fixed ring buffer that the overlay summarises and the CSV
+// export dumps. Everything here runs on the main thread only.
+
+// Phases of one main loop iteration
+enum ProfilePhase {
+    PHASE_IDLE,            // Blocked waiting for input or a timer tick
+    PHASE_EVENTS,          // Event polling and input handling
+    PHASE_ANIMATIONS,      // updateAnimations
+    PHASE_GAME_LOGIC,      // Rules, turn timer and computer moves
+    PHASE_POPUP,           // updatePopup
+    PHASE_DRAW_BOARD,      // drawBoard
+    PHASE_DRAW_HUD,        // Status bar, timer and exit button
+    PHASE_DRAW_ANIMATIONS, // drawAnimations
+    PHASE_DRAW_POPUP,      // drawWinnerPopup
+    PHASE_DISPLAY,         // window.display (includes the frame-rate limiter's sleep)
+    PHASE_COUNT
+};
+
+constexpr int PROFILER_HISTORY = 600; // Frames kept (10 seconds at 60 FPS)
+constexpr const char* PROFILER_CSV_PATH = "frame_profile.csv";
+
+// One frame's timings in milliseconds
+struct FrameProfile {
+    float phaseMs[PHASE_COUNT];
+    float frameMs; // Wall time from this frame's start to the next one's
+};
+
+/**
+ * @brief Adds the time until it goes out of scope to a phase of the current frame
+ */
+class ScopedPhaseTimer {
+public:
+    explicit ScopedPhaseTimer(ProfilePhase phase);
+    ~ScopedPhaseTimer();
+    ScopedPhaseTimer(const ScopedPhaseTimer&) = delete;
+    ScopedPhaseTimer& operator=(const ScopedPhaseTimer&) = delete;
+
+private:
+    ProfilePhase phase;
+    std::chrono::steady_clock::time_point start;
+};
+
+/**
+ * @brief Close the current frame (publishing it to the history) and start the next
+ */
+void beginProfilerFrame();
+
+/**
+ * @brief Copy the recorded history, oldest frame first (main thread only)
+ * @param out Receives up to PROFILER_HISTORY frames
+ * @return Number of frames copied
+ */
+int snapshotProfilerHistory(FrameProfile* out);
+
+/**
+ * @brief Write the recorded history as CSV (one row per frame, one column per phase)
+ * @return false if the file could not be written
+ */
+bool exportProfilerCSV(const char* path);
+
+void toggleProfilerOverlay();
+bool isProfilerOverlayVisible();
+
+/**
+ * @brief Draw the p50/p99 table and the frame-time graph
+ */
+void drawProfilerOverlay(sf::RenderWindow& window, const sf::Font& font);
+
+#endif // FRAME_PROFILER_H
@@ -0,0 +1,223 @@
+#include "game_record.h"
+#include <cstring>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr int MAX_PLIES = ROWS * COLS;
+
+/**
+ * @brief Size of the record starting at a position, or 0 if it is cut off or corrupt
+ */
+std::size_t recordSizeAt(const unsigned char* position, const unsigned char* end) {
+    if (end - position < 2) return 0;
+    int plies = position[0];
+    if (plies > MAX_PLIES || position[1] > RESULT_DRAW) return 0;
+    std::size_t size = 2 + (plies + 1) / 2;
+    return static_cast<std::size_t>(end - position) >= size ? size : 0;
+}
+
+/**
+ * @brief Cut a file to a length (the stream must be flushed)
+ */
+bool truncateFile(std::FILE* file, long length) {
+#ifdef _WIN32
+    return _chsize_s(_fileno(file), length) == 0;
+#else
+    return ftruncate(fileno(file), length) == 0;
+#endif
+}
+
+} // namespace
+
+GameRecordWriter::GameRecordWriter() : out(nullptr), used(0), written(0) {}
+
+GameRecordWriter::~GameRecordWriter() {
+    close();
+}
+
+/**
+ * @brief Open an archive for appending, writing the file header if it is new
+ *        A torn record left by a crash is cut off first, so the games
+ *        appended after it stay readable.
+ * @return false if the file cannot be opened or belongs to another format or board size
+ */
+bool GameRecordWriter::open(const char* path) {
+    close();
+    out = std::fopen(path, "rb+");
+    if (!out) out = std::fopen(path, "wb+");
+    if (!out) return false;
+
+    RecordFileHeader header = {RECORD_MAGIC, RECORD_VERSION, ROWS, COLS};
+    std::fseek(out, 0, SEEK_END);
+    long length = std::ftell(out);
+    if (length == 0) {
+        if (std::fwrite(&header, sizeof(header), 1, out) != 1) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    // Existing archive: only append to a compatible one
+    RecordFileHeader existing;
+    std::fseek(out, 0, SEEK_SET);
+    if (std::fread(&existing, sizeof(existing), 1, out) != 1 ||
+        std::memcmp(&existing, &header, sizeof(header)) != 0) {
+        std::fclose(out);
+        out = nullptr;
+        return false;
+    }
+
+    // Walk the records (buffered sequential reads) to the end of the last whole one
+    long valid = sizeof(header);
+    unsigned char record[2 + (MAX_PLIES + 1) / 2];
+    while (std::fread(record, 1, 2, out) == 2) {
+        std::size_t size = recordSizeAt(record, record + sizeof(record));
+        if (size == 0 || std::fread(record + 2, 1, size - 2, out) != size - 2) break;
+        valid += static_cast<long>(size);
+    }
+
+    if (valid != length && (std::fflush(out) != 0 || !truncateFile(out, valid))) {
+        std::fclose(out);
+        out = nullptr;
+        return false;
+    }
+    std::fseek(out, valid, SEEK_SET);
+    return true;
+}
+
+/**
+ * @brief Append one game (buffered)
+ * @return false if the writer is closed or a buffer flush failed
+ */
+bool GameRecordWriter::write(const GameRecord& record) {
+    if (!out) return false;
+    std::size_t size = 2 + (record.plies + 1) / 2;
+    if (used + size > BUFFER_SIZE && !flush()) return false;
+
+    unsigned char* p = buffer + used;
+    p[0] = record.plies;
+    p[1] = record.result;
+    for (int i = 0; i + 1 < record.plies; i += 2) {
+        p[2 + i / 2] = static_cast<unsigned char>(record.moves[i] | (record.moves[i + 1] << 4));
+    }
+    if (record.plies & 1) p[size - 1] = record.moves[record.plies - 1];
+
+    used += size;
+    ++written;
+    return true;
+}
+
+/**
+ * @brief Write the buffered records to the file
+ */
+bool GameRecordWriter::flush() {
+    if (!out) return false;
+    bool ok = std::fwrite(buffer, 1, used, out) == used && std::fflush(out) == 0;
+    used = 0;
+    return ok;
+}
+
+/**
+ * @brief Flush and close the archive (safe to call when already closed)
+ */
+bool GameRecordWriter::close() {
+    if (!out) return true;
+    bool ok = flush();
+    ok = std::fclose(out) == 0 && ok;
+    out = nullptr;
+    return ok;
+}
+
+GameArchive::Iterator::Iterator(const unsigned char* position, const unsigned char* end)
+    : view{position, 0, RESULT_UNFINISHED}, end(end) {
+    decode();
+}
+
+GameArchive::Iterator& GameArchive::Iterator::operator++() {
+    view.data += view.size();
+    decode();
+    return *this;
+}
+
+void GameArchive::Iterator::decode() {
+    // A torn or corrupt record ends the iteration
+    if (recordSizeAt(view.data, end) == 0) {
+        view.data = end;
+        view.plies = 0;
+        return;
+    }
+    view.plies = view.data[0];
+    view.result = view.data[1];
+}
+
+GameArchive::GameArchive() : file{nullptr, 0, nullptr} {}
+
+GameArchive::~GameArchive() {
+    close();
+}
+
+/**
+ * @brief Map an archive read-only
+ * @return false if the file is missing or its header does not match this board size
+ */
+bool GameArchive::open(const char* path) {
+    close();
+    if (!openMappedFile(file, path)) return false;
+
+    RecordFileHeader expected = {RECORD_MAGIC, RECORD_VERSION, ROWS, COLS};
+    if (file.size < sizeof(expected) || std::memcmp(file.data, &expected, sizeof(expected)) != 0) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void GameArchive::close() {
+    closeMappedFile(file);
+}
+
+GameArchive::Iterator GameArchive::begin() const {
+    if (!file.data) return Iterator(nullptr, nullptr);
+    return Iterator(file.data + sizeof(RecordFileHeader), file.data + file.size);
+}
+
+GameArchive::Iterator GameArchive::end() const {
+    const unsigned char* last = file.data ? file.data + file.size : nullptr;
+    return Iterator(last, last);
+}
+
+/**
+ * @brief Bytes after the last readable record (a torn final write or corruption)
+ */
+std::size_t GameArchive::trailingBytes() const {
+    if (!file.data) return 0;
+    const unsigned char* position = file.data + sizeof(RecordFileHeader);
+    const unsigned char* last = file.data + file.size;
+    while (std::size_t size = recordSizeAt(position, last)) position += size;
+    return static_cast<std::size_t>(last - position);
+}
+
+/**
+ * @brief Replay a record on a fresh board and compute its true result
+ * @return The result the moves lead to, or -1 if a move is illegal or
+ *         moves continue after the game was decided
+ */
+int replayGameRecord(const GameRecordView& record) {
+    Board board;
+    board.reset();
+    int player = 1;
+    for (int ply = 0; ply < record.plies; ++ply) {
+        if (board.winner) return -1;
+        if (board.drop(record.move(ply), player) < 0) return -1;
+        player = 3 - player;
+    }
+    if (board.winner) return board.winner == 1 ? RESULT_RED_WINS : RESULT_YELLOW_WINS;
+    return board.isFull() ? RESULT_DRAW : RESULT_UNFINISHED;
+}
@@ -0,0 +1,150 @@
+#ifndef GAME_RECORD_H
+#define GAME_RECORD_H
+
+#include "board.h"
+#include "mapped_file.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+// Default archive the game appends finished games to
+constexpr const char* GAME_RECORD_PATH = "games.c4g";
+
+// File layout: an 8-byte header followed by variable-length records.
+// Each record is a 2-byte header (ply count, result) and one nibble per ply
+// (column of the move, low nibble first), so a 42-ply game takes 23 bytes.
+constexpr std::uint32_t RECORD_MAGIC = 0x47523443; // "C4RG" read little-endian
+constexpr std::uint16_t RECORD_VERSION = 1;
+
+struct RecordFileHeader {
+    std::uint32_t magic;
+    std::uint16_t version;
+    std::uint8_t rows;      // Board size the games were played on
+    std::uint8_t cols;
+};
+
+// Outcome stored with every game
+enum GameResult {
+    RESULT_UNFINISHED, // Abandoned before a win or draw
+    RESULT_RED_WINS,
+    RESULT_YELLOW_WINS,
+    RESULT_DRAW
+};
+
+/**
+ * @brief One game as a list of columns (Red always moves first)
+ */
+struct GameRecord {
+    std::uint8_t plies;
+    std::uint8_t result;               // GameResult
+    std::uint8_t moves[ROWS * COLS];   // Column of every ply
+
+    void clear() {
+        plies = 0;
+        result = RESULT_UNFINISHED;
+    }
+
+    void addMove(int col) {
+        if (plies < ROWS * COLS) moves[plies++] = static_cast<std::uint8_t>(col);
+    }
+};
+
+/**
+ * @brief Appends records to an archive through a fixed-size buffer
+ *
+ * Records are packed into the buffer and written with one fwrite each time
+ * it fills, so appending a game is a few byte stores in the common case.
+ * Not thread-safe; callers sharing a writer must serialise write().
+ */
+class GameRecordWriter {
+public:
+    GameRecordWriter();
+    ~GameRecordWriter();
+    GameRecordWriter(const GameRecordWriter&) = delete;
+    GameRecordWriter& operator=(const GameRecordWriter&) = delete;
+
+    bool open(const char* path);
+    bool write(const GameRecord& record);
+    bool flush();
+    bool close();
+
+    bool isOpen() const { return out != nullptr; }
+    std::uint64_t recordsWritten() const { return written; }
+
+private:
+    static constexpr std::size_t BUFFER_SIZE = 64 * 1024;
+
+    std::FILE* out;
+    unsigned char buffer[BUFFER_SIZE];
+    std::size_t used;
+    std::uint64_t written;
+};
+
+/**
+ * @brief Read-only view of one record inside a mapped archive
+ */
+struct GameRecordView {
+    const unsigned char* data; // Start of the record header
+    int plies;
+    int result;                // GameResult
+
+    /**
+     * @brief Column played at a given ply
+     */
+    int move(int ply) const {
+        unsigned char packed = data[2 + ply / 2];
+        return (ply & 1) ? (packed >> 4) : (packed & 0x0F);
+    }
+
+    /**
+     * @brief Bytes taken by the record, header included
+     */
+    std::size_t size() const { return 2 + (plies + 1) / 2; }
+};
+
+/**
+ * @brief Memory-mapped archive, iterated record by record without copying
+ */
+class GameArchive {
+public:
+    class Iterator {
+    public:
+        Iterator(const unsigned char* position, const unsigned char* end);
+        const GameRecordView& operator*() const { return view; }
+        const GameRecordView* operator->() const { return &view; }
+        Iterator& operator++();
+        bool operator!=(const Iterator& other) const { return view.data != other.view.data; }
+
+    private:
+        void decode();
+
+        GameRecordView view;
+        const unsigned char* end;
+    };
+
+    GameArchive();
+    ~GameArchive();
+    GameArchive(const GameArchive&) = delete;
+    GameArchive& operator=(const GameArchive&) = delete;
+
+    bool open(const char* path);
+    void close();
+
+    Iterator begin() const;
+    Iterator end() const;
+
+    std::size_t sizeBytes() const { return file.size; }
+    std::size_t trailingBytes() const;
+
+private:
+    MappedFile file;
+};
+
+/**
+ * @brief Replay a record on a fresh board and compute its true result
+ * @return The result the moves lead to, or -1 if a move is illegal or
+ *         moves continue after the game was decided
+ */
+int replayGameRecord(const GameRecordView& record);
+
+#endif // GAME_RECORD_H
@@ -0,0 +1,13 @@
+#ifndef LAYOUT_H
+#define LAYOUT_H
+
+#include "board.h"
+
+// Screen layout shared by every drawing module, derived from the board size
+constexpr float CELL_SIZE = 100.0f;        // Size of each cell in pixels
+constexpr float PIECE_RADIUS = 40.0f;      // Radius of the game pieces
+constexpr float STATUS_BAR_HEIGHT = 50.0f; // Strip under the board for status, timer and exit button
+constexpr int WINDOW_WIDTH = static_cast<int>(COLS * CELL_SIZE);
+constexpr int WINDOW_HEIGHT = static_cast<int>(ROWS * CELL_SIZE + STATUS_BAR_HEIGHT);
+
+#endif // LAYOUT_H
@@ -0,0 +1,284 @@
+// Load generator for connect4_server (Linux, epoll).
+// Build with: make server
+// Usage: connect4_loadgen [--host ADDR] [--port P] [--connections N] [--seconds S] [--seed S]
+//
+// Opens N connections from one epoll loop. Each plays random legal moves
+// against the server back to back, one request in flight per connection,
+// and the run ends with matches per second and the move round-trip latency
+// distribution (p50 / p99 / max).
+
+#include "match_protocol.h"
+#include "rules.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <string>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+using LoadClock = std::chrono::steady_clock;
+
+struct LoadConfig {
+    const char* host = "127.0.0.1";
+    int port = MATCH_DEFAULT_PORT;
+    int connections = 1000;
+    double seconds = 10.0;
+    std::uint64_t seed = 1;
+};
+
+constexpr int MAX_EVENTS = 256;
+
+// One simulated player; mirrors its match locally to pick legal moves
+struct Client {
+    int fd = -1;
+    bool connected = false;
+    Board board;
+    int lastColumn = -1;
+    std::uint64_t rng = 1;
+    LoadClock::time_point sentAt;
+    std::string input;
+};
+
+struct LoadStats {
+    std::uint64_t matches = 0;
+    std::uint64_t results[4] = {0, 0, 0, 0}; // Indexed by MatchState
+    std::uint64_t errors = 0;
+    std::uint64_t disconnects = 0;
+    std::vector<float> latencyUs;            // One sample per MOVE round trip
+};
+
+bool parseArgs(int argc, char* argv[], LoadConfig& config) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--host" && hasValue) config.host = argv[++i];
+        else if (arg == "--port" && hasValue) config.port = std::atoi(argv[++i]);
+        else if (arg == "--connections" && hasValue) config.connections = std::atoi(argv[++i]);
+        else if (arg == "--seconds" && hasValue) config.seconds = std::atof(argv[++i]);
+        else if (arg == "--seed" && hasValue) config.seed = std::strtoull(argv[++i], nullptr, 10);
+        else return false;
+    }
+    return config.connections > 0 && config.seconds > 0.0;
+}
+
+/**
+ * @brief Send one request line
+ *        Requests are a few bytes with one in flight per connection, so a
+ *        loopback socket always takes them whole; anything else is an error.
+ */
+bool sendLine(Client& client, const char* line) {
+    std::size_t length = std::strlen(line);
+    ssize_t sent = send(client.fd, line, length, MSG_NOSIGNAL);
+    return sent == static_cast<ssize_t>(length);
+}
+
+bool startMatch(Client& client) {
+    resetBoard(client.board);
+    return sendLine(client, "NEW\n");
+}
+
+bool sendMove(Client& client) {
+    client.lastColumn = randomLegalColumn(client.board, client.rng);
+    char line[16];
+    std::snprintf(line, sizeof(line), "MOVE %d\n", client.lastColumn);
+    client.sentAt = LoadClock::now();
+    return sendLine(client, line);
+}
+
+/**
+ * @brief React to one server line
+ * @return false if the connection should be dropped
+ */
+bool handleLine(Client& client, const std::string& line, LoadStats& stats) {
+    if (line == "OK") return sendMove(client);
+
+    int clientColumn, serverColumn;
+    char state[16];
+    if (std::sscanf(line.c_str(), "MOVED %d %d %15s", &clientColumn, &serverColumn, state) == 3) {
+        float micros = std::chrono::duration<float, std::micro>(LoadClock::now() - client.sentAt).count();
+        stats.latencyUs.push_back(micros);
+
+        dropPiece(client.board, clientColumn, 1);
+        if (serverColumn >= 0) dropPiece(client.board, serverColumn, 2);
+        for (int s = 0; s < 4; ++s) {
+            if (std::strcmp(state, MATCH_STATE_NAMES[s]) != 0) continue;
+            if (s == MATCH_PLAYING) return sendMove(client);
+            ++stats.matches;
+            ++stats.results[s];
+            return startMatch(client);
+        }
+    }
+
+    // ERR or anything unexpected: count it and start over
+    ++stats.errors;
+    return startMatch(client);
+}
+
+bool openClient(Client& client, const sockaddr_in& address, int epollFd) {
+    client.fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (client.fd < 0) return false;
+    int noDelay = 1;
+    setsockopt(client.fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+    if (connect(client.fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) < 0 &&
+        errno != EINPROGRESS) {
+        close(client.fd);
+        client.fd = -1;
+        return false;
+    }
+
+    // Writable once the connection is established
+    epoll_event event = {};
+    event.events = EPOLLOUT | EPOLLIN | EPOLLRDHUP;
+    event.data.fd = client.fd;
+    return epoll_ctl(epollFd, EPOLL_CTL_ADD, client.fd, &event) == 0;
+}
+
+void closeClient(Client& client, int epollFd) {
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, client.fd, nullptr);
+    close(client.fd);
+    client.fd = -1;
+    client.connected = false;
+}
+
+/**
+ * @brief Handle readiness on one client socket
+ * @return false if the connection was lost
+ */
+bool serviceClient(Client& client, std::uint32_t eventMask, int epollFd, LoadStats& stats) {
+    if (eventMask & (EPOLLERR | EPOLLHUP)) return false;
+
+    if (!client.connected && (eventMask & EPOLLOUT)) {
+        client.connected = true;
+        epoll_event event = {};
+        event.events = EPOLLIN | EPOLLRDHUP;
+        event.data.fd = client.fd;
+        epoll_ctl(epollFd, EPOLL_CTL_MOD, client.fd, &event);
+        if (!startMatch(client)) return false;
+    }
+
+    if (eventMask & (EPOLLIN | EPOLLRDHUP)) {
+        char buffer[1024];
+        for (;;) {
+            ssize_t got = recv(client.fd, buffer, sizeof(buffer), 0);
+            if (got > 0) {
+                client.input.append(buffer, static_cast<std::size_t>(got));
+                continue;
+            }
+            if (got < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+            if (got < 0 && errno == EINTR) continue;
+            return false;
+        }
+        std::size_t start = 0;
+        for (std::size_t end; (end = client.input.find('\n', start)) != std::string::npos; start = end + 1) {
+            if (!handleLine(client, client.input.substr(start, end - start), stats)) return false;
+        }
+        client.input.erase(0, start);
+    }
+    return true;
+}
+
+/**
+ * @brief Nearest-rank percentile (reorders the samples)
+ */
+float percentile(std::vector<float>& samples, double fraction) {
+    if (samples.empty()) return 0.0f;
+    std::size_t rank = std::min(samples.size() - 1, static_cast<std::size_t>(fraction * samples.size()));
+    std::nth_element(samples.begin(), samples.begin() + rank, samples.end());
+    return samples[rank];
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    LoadConfig config;
+    if (!parseArgs(argc, argv, config)) {
+        std::fprintf(stderr, "Usage: %s [--host ADDR] [--port P] [--connections N] [--seconds S] [--seed S]\n", argv[0]);
+        return 1;
+    }
+    std::signal(SIGPIPE, SIG_IGN);
+
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<std::uint16_t>(config.port));
+    if (inet_pton(AF_INET, config.host, &address.sin_addr) != 1) {
+        std::fprintf(stderr, "Invalid IPv4 address: %s\n", config.host);
+        return 1;
+    }
+
+    int epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd < 0) {
+        std::perror("epoll_create1");
+        return 1;
+    }
+
+    // Clients are looked up by descriptor
+    std::vector<Client> clients;
+    LoadStats stats;
+    stats.latencyUs.reserve(1 << 20);
+    int opened = 0;
+    for (int i = 0; i < config.connections; ++i) {
+        Client client;
+        client.rng = mixSeed(config.seed ^ mixSeed(static_cast<std::uint64_t>(i))) | 1;
+        if (!openClient(client, address, epollFd)) {
+            std::perror("connect");
+            break;
+        }
+        if (static_cast<std::size_t>(client.fd) >= clients.size()) clients.resize(client.fd + 1);
+        clients[client.fd] = client;
+        ++opened;
+    }
+    std::printf("Load: %d connections to %s:%d for %.1f s\n", opened, config.host, config.port, config.seconds);
+
+    LoadClock::time_point start = LoadClock::now();
+    LoadClock::time_point stop = start + std::chrono::duration_cast<LoadClock::duration>(
+                                             std::chrono::duration<double>(config.seconds));
+    epoll_event events[MAX_EVENTS];
+    int live = opened;
+    while (live > 0 && LoadClock::now() < stop) {
+        int count = epoll_wait(epollFd, events, MAX_EVENTS, 100);
+        if (count < 0 && errno != EINTR) {
+            std::perror("epoll_wait");
+            break;
+        }
+        for (int i = 0; i < count; ++i) {
+            Client& client = clients[events[i].data.fd];
+            if (client.fd < 0) continue;
+            if (!serviceClient(client, events[i].events, epollFd, stats)) {
+                closeClient(client, epollFd);
+                ++stats.disconnects;
+                --live;
+            }
+        }
+    }
+    double elapsed = std::chrono::duration<double>(LoadClock::now() - start).count();
+    for (Client& client : clients) {
+        if (client.fd >= 0) closeClient(client, epollFd);
+    }
+    close(epollFd);
+
+    std::size_t moves = stats.latencyUs.size();
+    float p50 = percentile(stats.latencyUs, 0.50);
+    float p99 = percentile(stats.latencyUs, 0.99);
+    float worst = stats.latencyUs.empty() ? 0.0f : *std::max_element(stats.latencyUs.begin(), stats.latencyUs.end());
+    std::printf("Matches %llu (%.0f/s) | red %llu | yellow %llu | draw %llu | moves %zu (%.0f/s)\n",
+                static_cast<unsigned long long>(stats.matches), stats.matches / elapsed,
+                static_cast<unsigned long long>(stats.results[MATCH_RED_WINS]),
+                static_cast<unsigned long long>(stats.results[MATCH_YELLOW_WINS]),
+                static_cast<unsigned long long>(stats.results[MATCH_DRAW]),
+                moves, moves / elapsed);
+    std::printf("Move latency: p50 %.0f us | p99 %.0f us | max %.0f us | errors %llu | disconnects %llu\n",
+                p50, p99, worst, static_cast<unsigned long long>(stats.errors),
+                static_cast<unsigned long long>(stats.disconnects));
+    return stats.disconnects > 0 || stats.errors > 0 ? 2 : 0;
+}
@@ -0,0 +1,53 @@
+#ifndef MAILBOX_H
+#define MAILBOX_H
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief Single-producer, single-consumer mailbox that keeps only the newest value
+ *
+ * Triple buffer: the producer fills its own slot and swaps it with the shared
+ * middle slot in one atomic exchange; the consumer swaps the middle slot out
+ * the same way. Neither side waits or allocates, and a value the consumer has
+ * not taken yet is replaced by the next one.
+ */
+template <typename T>
+class LatestMailbox {
+public:
+    /**
+     * @brief Slot to fill before publish() (producer thread only)
+     */
+    T& draft() {
+        return slots[writeSlot];
+    }
+
+    /**
+     * @brief Make the draft the newest value (producer thread only)
+     */
+    void publish() {
+        writeSlot = middle.exchange(static_cast<std::uint8_t>(writeSlot | FRESH), std::memory_order_acq_rel) & SLOT_MASK;
+    }
+
+    /**
+     * @brief Copy out the newest value if one arrived since the last call (consumer thread only)
+     * @return false if nothing new was published
+     */
+    bool take(T& out) {
+        if (!(middle.load(std::memory_order_relaxed) & FRESH)) return false;
+        readSlot = middle.exchange(readSlot, std::memory_order_acq_rel) & SLOT_MASK;
+        out = slots[readSlot];
+        return true;
+    }
+
+private:
+    static constexpr std::uint8_t SLOT_MASK = 3;
+    static constexpr std::uint8_t FRESH = 4; // Set in `middle` until the consumer takes it
+
+    T slots[3] = {};
+    std::uint8_t writeSlot = 0;           // Owned by the producer
+    std::uint8_t readSlot = 1;            // Owned by the consumer
+    std::atomic<std::uint8_t> middle{2};  // Shared slot index plus the FRESH flag
+};
+
+#endif // MAILBOX_H
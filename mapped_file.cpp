@@ -0,0 +1,78 @@
+#include "mapped_file.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief Map a file read-only into memory
+ * @param file Mapping to fill in (left closed on failure)
+ * @param path File to open
+ * @return true if the file was mapped, false if it is missing, empty or unreadable
+ */
+bool openMappedFile(MappedFile& file, const char* path) {
+    file.data = nullptr;
+    file.size = 0;
+    file.handle = nullptr;
+
+#ifdef _WIN32
+    HANDLE fileHandle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                    OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER length;
+    if (!GetFileSizeEx(fileHandle, &length) || length.QuadPart == 0) {
+        CloseHandle(fileHandle);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(fileHandle); // The mapping keeps the file open
+    if (!mapping) return false;
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mapping);
+        return false;
+    }
+    file.data = static_cast<const unsigned char*>(view);
+    file.size = static_cast<std::size_t>(length.QuadPart);
+    file.handle = mapping;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        close(fd);
+        return false;
+    }
+    void* view = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd); // The mapping keeps the file open
+    if (view == MAP_FAILED) return false;
+
+    file.data = static_cast<const unsigned char*>(view);
+    file.size = static_cast<std::size_t>(info.st_size);
+#endif
+    return true;
+}
+
+/**
+ * @brief Unmap a file opened with openMappedFile (safe to call when closed)
+ */
+void closeMappedFile(MappedFile& file) {
+    if (!file.data) return;
+#ifdef _WIN32
+    UnmapViewOfFile(file.data);
+    CloseHandle(static_cast<HANDLE>(file.handle));
+#else
+    munmap(const_cast<unsigned char*>(file.data), file.size);
+#endif
+    file.data = nullptr;
+    file.size = 0;
+    file.handle = nullptr;
+}
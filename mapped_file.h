@@ -0,0 +1,17 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+
+// Read-only memory mapping of a whole file
+struct MappedFile {
+    const unsigned char* data; // Start of the mapping (nullptr when closed)
+    std::size_t size;          // Length in bytes
+    void* handle;              // Platform mapping handle (Windows only)
+};
+
+// Mapped file functions
+bool openMappedFile(MappedFile& file, const char* path);
+void closeMappedFile(MappedFile& file);
+
+#endif // MAPPED_FILE_H
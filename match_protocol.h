@@ -0,0 +1,24 @@
+#ifndef MATCH_PROTOCOL_H
+#define MATCH_PROTOCOL_H
+
+// Line protocol spoken by connect4_server and connect4_loadgen.
+// Every message is one ASCII line ending in '\n'.
+//
+//   client: NEW            -> server: OK                  (start a match; client is Red, server Yellow)
+//   client: MOVE <col>     -> server: MOVED <col> <reply> <state>
+//                                     reply = server's column, -1 if the game ended first
+//                                     state = PLAY | RED | YELLOW | DRAW
+//   client: QUIT           -> server closes the connection
+//   anything invalid       -> server: ERR <reason>        (no-match, illegal, busy, unknown, full)
+//
+// Each connection plays one match at a time; NEW abandons a match in progress.
+
+constexpr int MATCH_DEFAULT_PORT = 7777;
+constexpr int MATCH_MAX_LINE = 64; // Longer lines close the connection
+
+// Match state as sent in MOVED replies
+enum MatchState { MATCH_PLAYING, MATCH_RED_WINS, MATCH_YELLOW_WINS, MATCH_DRAW };
+
+constexpr const char* MATCH_STATE_NAMES[4] = {"PLAY", "RED", "YELLOW", "DRAW"};
+
+#endif // MATCH_PROTOCOL_H
@@ -0,0 +1,198 @@
+#include "mcts.h"
+#include "rules.h"
+#include "trace.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace {
+
+// Playouts a thread runs between checks of the shared limits
+constexpr std::uint64_t PLAYOUT_CHECK_INTERVAL = 64;
+
+using SearchClock = std::chrono::steady_clock;
+
+/**
+ * @brief Give a leaf one child per legal move, carved from the thread's arena
+ * @return The children, or nullptr if another thread got there first or the arena is full
+ */
+template <class B>
+MCTSNode* expand(MCTSNode& node, const B& board, MCTSArena& arena) {
+    if (node.claimed.exchange(true, std::memory_order_acquire)) return nullptr;
+
+    int count = 0;
+    for (int col = 0; col < B::COLS; ++col) count += board.canPlay(col);
+    if (arena.used + count > arena.capacity) {
+        node.claimed.store(false, std::memory_order_relaxed); // Another thread may have room
+        return nullptr;
+    }
+
+    MCTSNode* children = &arena.nodes[arena.used];
+    arena.used += count;
+    for (int col = 0, i = 0; col < B::COLS; ++col) {
+        if (board.canPlay(col)) children[i++].reset(col);
+    }
+    node.childCount = static_cast<std::uint8_t>(count);
+    node.children.store(children, std::memory_order_release);
+    return children;
+}
+
+/**
+ * @brief UCT: the child with the best mean result plus exploration bonus
+ *        Unvisited children come first; pending visits count as losses.
+ */
+MCTSNode* selectChild(const MCTSNode& node, MCTSNode* children, double exploration) {
+    double logParent = std::log(static_cast<double>(std::max(node.visits.load(std::memory_order_relaxed), 1)));
+    MCTSNode* best = children;
+    double bestValue = -1.0;
+    for (int i = 0; i < node.childCount; ++i) {
+        std::int32_t visits = children[i].visits.load(std::memory_order_relaxed);
+        if (visits <= 0) return &children[i];
+        double mean = children[i].score.load(std::memory_order_relaxed) / (2.0 * visits);
+        double value = mean + exploration * std::sqrt(logParent / visits);
+        if (value > bestValue) {
+            bestValue = value;
+            best = &children[i];
+        }
+    }
+    return best;
+}
+
+} // namespace
+
+void MCTSNode::reset(int move) {
+    children.store(nullptr, std::memory_order_relaxed);
+    visits.store(0, std::memory_order_relaxed);
+    score.store(0, std::memory_order_relaxed);
+    claimed.store(false, std::memory_order_relaxed);
+    column = static_cast<std::int8_t>(move);
+    childCount = 0;
+}
+
+MCTSSearch::MCTSSearch(std::size_t arenaNodes, std::uint64_t seed) : arenaNodes(arenaNodes), seed(seed) {}
+
+/**
+ * @brief Run the four MCTS phases until a limit is reached
+ *
+ * Selection charges MCTS_VIRTUAL_LOSS visits to every node on the path;
+ * backup swaps them for the single real visit and adds the result.
+ */
+template <class B>
+void MCTSSearch::worker(const B& board, int player, const MCTSConfig& config, int thread) {
+    MCTSArena& arena = arenas[thread];
+    std::uint64_t rng = mixSeed(seed ^ mixSeed(searches * 1024 + static_cast<std::uint64_t>(thread))) | 1;
+    MCTSNode* path[B::CELLS + 1];
+    std::uint64_t pending = 0; // Playouts not yet added to sharedPlayouts
+
+    while (!stop.load(std::memory_order_relaxed)) {
+        B position = board;
+        int mover = player;
+        int length = 0;
+        MCTSNode* node = &root;
+        node->visits.fetch_add(MCTS_VIRTUAL_LOSS, std::memory_order_relaxed);
+        path[length++] = node;
+
+        // Selection and expansion: descend until a leaf or the end of the game
+        while (position.winner == 0 && !position.isFull()) {
+            MCTSNode* children = node->children.load(std::memory_order_acquire);
+            if (!children) {
+                // A leaf grows once it has a completed visit besides this one
+                if (node->visits.load(std::memory_order_relaxed) <= MCTS_VIRTUAL_LOSS) break;
+                children = expand(*node, position, arena);
+                if (!children) break;
+            }
+            node = selectChild(*node, children, config.exploration);
+            node->visits.fetch_add(MCTS_VIRTUAL_LOSS, std::memory_order_relaxed);
+            path[length++] = node;
+            position.drop(node->column, mover);
+            mover = (mover == 1) ? 2 : 1;
+        }
+
+        // Simulation: a finished game scores itself, otherwise play it out at random
+        int winner = position.winner;
+        if (winner == 0 && !position.isFull()) winner = playRandomGame(position, mover, rng);
+
+        // Backup: the root was reached by the opponent's move, then movers alternate
+        int movedHere = (player == 1) ? 2 : 1;
+        for (int i = 0; i < length; ++i) {
+            std::int32_t points = (winner == 0) ? 1 : (winner == movedHere ? 2 : 0);
+            path[i]->score.fetch_add(points, std::memory_order_relaxed);
+            path[i]->visits.fetch_add(1 - MCTS_VIRTUAL_LOSS, std::memory_order_relaxed);
+            movedHere = (movedHere == 1) ? 2 : 1;
+        }
+
+        if (++pending >= PLAYOUT_CHECK_INTERVAL) {
+            std::uint64_t total = sharedPlayouts.fetch_add(pending, std::memory_order_relaxed) + pending;
+            pending = 0;
+            if ((config.playoutLimit && total >= config.playoutLimit) ||
+                (hasDeadline && SearchClock::now() >= deadline)) {
+                stop.store(true, std::memory_order_relaxed);
+            }
+        }
+    }
+    sharedPlayouts.fetch_add(pending, std::memory_order_relaxed);
+}
+
+template <class B>
+MCTSResult MCTSSearch::search(const B& board, int player, const MCTSConfig& config) {
+    TRACE_SCOPE("mcts");
+    SearchClock::time_point start = SearchClock::now();
+    MCTSResult result = {-1, 0.0, 0, 0, 0.0};
+    if (board.winner != 0 || board.isFull()) return result;
+    for (int col = 0; col < B::COLS && result.column < 0; ++col) {
+        if (board.canPlay(col)) result.column = col; // In case the root is never expanded
+    }
+    // Without any limit the workers would never stop
+    if (config.timeLimit <= 0.0 && config.playoutLimit == 0) return result;
+
+    // Empty every arena in one step; new threads get theirs on first use
+    int threads = std::max(1, config.threads);
+    if (static_cast<int>(arenas.size()) < threads) arenas.resize(threads);
+    for (int t = 0; t < threads; ++t) {
+        MCTSArena& arena = arenas[t];
+        if (!arena.nodes) {
+            arena.nodes.reset(new MCTSNode[arenaNodes]);
+            arena.capacity = arenaNodes;
+        }
+        arena.used = 0;
+    }
+    root.reset(-1);
+    ++searches;
+
+    sharedPlayouts.store(0, std::memory_order_relaxed);
+    stop.store(false, std::memory_order_relaxed);
+    hasDeadline = config.timeLimit > 0.0;
+    deadline = start + std::chrono::duration_cast<SearchClock::duration>(
+                           std::chrono::duration<double>(config.timeLimit));
+
+    std::vector<std::thread> helpers;
+    for (int t = 1; t < threads; ++t) {
+        helpers.emplace_back([&, t] {
+            TRACE_THREAD_NAME("mcts_helper");
+            worker(board, player, config, t);
+        });
+    }
+    worker(board, player, config, 0);
+    for (std::thread& helper : helpers) helper.join();
+
+    // The most visited move is the most robust choice
+    MCTSNode* children = root.children.load(std::memory_order_acquire);
+    std::int32_t bestVisits = 0;
+    for (int i = 0; children && i < root.childCount; ++i) {
+        std::int32_t visits = children[i].visits.load(std::memory_order_relaxed);
+        if (visits > bestVisits) {
+            bestVisits = visits;
+            result.column = children[i].column;
+            result.value = children[i].score.load(std::memory_order_relaxed) / (2.0 * visits);
+        }
+    }
+    result.playouts = sharedPlayouts.load(std::memory_order_relaxed);
+    for (int t = 0; t < threads; ++t) result.nodes += arenas[t].used;
+    result.seconds = std::chrono::duration<double>(SearchClock::now() - start).count();
+    return result;
+}
+
+// Explicit instantiations for every board variant
+template MCTSResult MCTSSearch::search<Board>(const Board&, int, const MCTSConfig&);
+template MCTSResult MCTSSearch::search<Board7x8>(const Board7x8&, int, const MCTSConfig&);
+template MCTSResult MCTSSearch::search<BoardConnect5>(const BoardConnect5&, int, const MCTSConfig&);
@@ -0,0 +1,125 @@
+#ifndef MCTS_H
+#define MCTS_H
+
+#include "board.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Monte Carlo tree search for positions (or board variants) where the
+// alpha-beta search cannot see far enough in the time it has. Every thread
+// walks the one shared tree with UCT, adds a virtual loss to the nodes on its
+// path so the others spread out, finishes the game with random moves and
+// backs the result up. Nodes live in per-thread bump arenas that are emptied
+// in one step when the next search starts, so the tree is never freed node by node.
+
+constexpr double MCTS_EXPLORATION = 1.4;           // UCT exploration constant (results are 0..1)
+constexpr int MCTS_VIRTUAL_LOSS = 3;               // Losses a thread charges each node on its path
+constexpr std::size_t MCTS_ARENA_NODES = 1 << 19;  // Node capacity of each thread's arena
+
+// Search limits for a single move (with neither limit set, search() returns
+// the first legal column without searching)
+struct MCTSConfig {
+    double timeLimit;             // Seconds, 0 = no time limit
+    std::uint64_t playoutLimit;   // Total over all threads, 0 = no playout limit
+    int threads = 1;              // Threads sharing the tree
+    double exploration = MCTS_EXPLORATION;
+};
+
+// Outcome of a search
+struct MCTSResult {
+    int column;             // Most visited root move (-1 if no legal move)
+    double value;           // Mean result of that move for the mover (0 = loss, 0.5 = draw, 1 = win)
+    std::uint64_t playouts; // Playouts by all threads
+    std::uint64_t nodes;    // Tree nodes allocated
+    double seconds;         // Wall-clock time taken
+
+    double playoutsPerSecond() const {
+        return seconds > 0.0 ? playouts / seconds : 0.0;
+    }
+};
+
+/**
+ * @brief Tree node, shared by every search thread
+ *
+ * Children are expanded together into one run of consecutive nodes, claimed
+ * by whichever thread sets `claimed` first. Visits include the virtual
+ * losses of threads still below the node; score is only added on the way
+ * back up, so a pending visit counts as a loss until it completes.
+ */
+struct MCTSNode {
+    std::atomic<MCTSNode*> children{nullptr}; // First of childCount nodes, null until expanded
+    std::atomic<std::int32_t> visits{0};
+    std::atomic<std::int32_t> score{0};       // Half-points for the player who moved here (win 2, draw 1)
+    std::atomic<bool> claimed{false};         // A thread is expanding (or has expanded) the node
+    std::int8_t column = -1;                  // Move that leads here
+    std::uint8_t childCount = 0;              // Written before children is published
+
+    void reset(int move);
+};
+
+// One thread's node storage: runs of nodes are carved off the front, and
+// the whole arena is emptied at once by setting used back to zero
+struct alignas(64) MCTSArena {
+    std::unique_ptr<MCTSNode[]> nodes;
+    std::size_t capacity = 0;
+    std::size_t used = 0;
+};
+
+/**
+ * @brief Multi-threaded UCT player for every board variant in board.h
+ *
+ * Arenas are allocated the first time a thread needs one and kept for the
+ * next search, so a searcher reused move after move allocates nothing.
+ */
+class MCTSSearch {
+public:
+    /**
+     * @param arenaNodes Node capacity per thread; a thread whose arena is full
+     *        keeps running playouts but stops growing the tree
+     * @param seed Seed of the playout generators
+     */
+    explicit MCTSSearch(std::size_t arenaNodes = MCTS_ARENA_NODES, std::uint64_t seed = 1);
+    MCTSSearch(const MCTSSearch&) = delete;
+    MCTSSearch& operator=(const MCTSSearch&) = delete;
+
+    /**
+     * @brief Search a position, discarding the tree of the previous search
+     * @param board Position to search
+     * @param player Player to move (1=Red, 2=Yellow)
+     * @param config Time, playout and thread limits
+     * @return Most visited move
+     */
+    template <class B>
+    MCTSResult search(const B& board, int player, const MCTSConfig& config);
+
+    /**
+     * @brief Restart the playout generators from a new seed
+     *        Single-threaded searches then repeat exactly for the same seed.
+     */
+    void setSeed(std::uint64_t value) {
+        seed = value;
+        searches = 0;
+    }
+
+private:
+    template <class B>
+    void worker(const B& board, int player, const MCTSConfig& config, int thread);
+
+    std::size_t arenaNodes;
+    std::uint64_t seed;
+    std::uint64_t searches = 0; // Varies the playouts from one search to the next
+    std::vector<MCTSArena> arenas;
+    MCTSNode root;
+
+    // Limits shared by the threads of the search in progress
+    std::atomic<std::uint64_t> sharedPlayouts{0};
+    std::atomic<bool> stop{false};
+    bool hasDeadline = false;
+    std::chrono::steady_clock::time_point deadline;
+};
+
+#endif // MCTS_H
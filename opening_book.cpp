@@ -0,0 +1,160 @@
+#include "opening_book.h"
+#include "ai.h"
+#include "mapped_file.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+constexpr int KEY_BITS = COLS * COLUMN_BITS;
+constexpr int MOVE_SHIFT = 12;
+constexpr int KEY_SHIFT = 15;
+constexpr std::uint64_t SCORE_MASK = (1u << MOVE_SHIFT) - 1;
+constexpr std::uint64_t COLUMN_CHUNK = (std::uint64_t(1) << COLUMN_BITS) - 1;
+
+// Scores are squeezed into 12 signed bits: heuristic scores are clamped to
+// +-WIN_CODE_BASE and proven wins/losses keep their distance in plies
+constexpr int WIN_CODE_BASE = 1900;
+constexpr int WIN_CODE_MAX = 2047;
+
+static_assert(KEY_BITS + KEY_SHIFT <= 64, "Book key does not fit in an entry");
+
+MappedFile g_bookFile = {nullptr, 0, nullptr};
+const std::uint64_t* g_bookEntries = nullptr;
+std::uint64_t g_bookCount = 0;
+
+std::uint64_t mirrorKey(std::uint64_t key) {
+    std::uint64_t mirrored = 0;
+    for (int c = 0; c < COLS; ++c) {
+        std::uint64_t chunk = (key >> (c * COLUMN_BITS)) & COLUMN_CHUNK;
+        mirrored |= chunk << ((COLS - 1 - c) * COLUMN_BITS);
+    }
+    return mirrored;
+}
+
+int encodeScore(int score) {
+    int winDistance = AI_WIN_SCORE - std::abs(score);
+    if (winDistance <= ROWS * COLS) {
+        int code = WIN_CODE_MAX - winDistance;
+        return score > 0 ? code : -code;
+    }
+    return std::max(-WIN_CODE_BASE, std::min(WIN_CODE_BASE, score));
+}
+
+int decodeScore(int code) {
+    if (std::abs(code) > WIN_CODE_BASE) {
+        int score = AI_WIN_SCORE - (WIN_CODE_MAX - std::abs(code));
+        return code > 0 ? score : -score;
+    }
+    return code;
+}
+
+} // namespace
+
+/**
+ * @brief Position key shared by a position and its left-right mirror image
+ * @param board Position to look up
+ * @param mirrored Set to true if the mirrored key was chosen
+ * @return The smaller of the key and its mirror
+ */
+std::uint64_t canonicalBookKey(const Board& board, bool& mirrored) {
+    std::uint64_t key = board.key();
+    std::uint64_t flipped = mirrorKey(key);
+    mirrored = flipped < key;
+    return mirrored ? flipped : key;
+}
+
+/**
+ * @brief Pack a book entry (column must be in canonical orientation)
+ */
+std::uint64_t packBookEntry(std::uint64_t key, int column, int score) {
+    std::uint64_t code = static_cast<std::uint64_t>(encodeScore(score)) & SCORE_MASK;
+    return (key << KEY_SHIFT) | (static_cast<std::uint64_t>(column) << MOVE_SHIFT) | code;
+}
+
+/**
+ * @brief Sort entries and write them with a header
+ * @return true on success
+ */
+bool writeOpeningBook(const char* path, std::vector<std::uint64_t>& entries, int maxPly) {
+    std::sort(entries.begin(), entries.end());
+
+    FILE* out = std::fopen(path, "wb");
+    if (!out) return false;
+
+    BookHeader header = {BOOK_MAGIC, BOOK_VERSION, static_cast<std::uint8_t>(maxPly), 0, entries.size()};
+    bool ok = std::fwrite(&header, sizeof(header), 1, out) == 1 &&
+              std::fwrite(entries.data(), sizeof(std::uint64_t), entries.size(), out) == entries.size();
+    return std::fclose(out) == 0 && ok;
+}
+
+/**
+ * @brief Map a book file read-only; the entries stay on disk / in the page cache
+ * @return true if a valid book was opened
+ */
+bool openOpeningBook(const char* path) {
+    closeOpeningBook();
+    if (!openMappedFile(g_bookFile, path)) return false;
+
+    BookHeader header;
+    if (g_bookFile.size < sizeof(header)) {
+        closeOpeningBook();
+        return false;
+    }
+    std::memcpy(&header, g_bookFile.data, sizeof(header));
+    if (header.magic != BOOK_MAGIC || header.version != BOOK_VERSION ||
+        g_bookFile.size != sizeof(header) + header.count * sizeof(std::uint64_t)) {
+        closeOpeningBook();
+        return false;
+    }
+    // The header is 16 bytes, so the entry array stays 8-byte aligned
+    g_bookEntries = reinterpret_cast<const std::uint64_t*>(g_bookFile.data + sizeof(header));
+    g_bookCount = header.count;
+    return true;
+}
+
+/**
+ * @brief Release the book mapping
+ */
+void closeOpeningBook() {
+    closeMappedFile(g_bookFile);
+    g_bookEntries = nullptr;
+    g_bookCount = 0;
+}
+
+/**
+ * @brief Check whether a book is currently mapped
+ */
+bool isOpeningBookOpen() {
+    return g_bookEntries != nullptr;
+}
+
+/**
+ * @brief Look a position up by binary search
+ * @param board Position (side to move from the move count)
+ * @param column Best column for the side to move
+ * @param score Stored score from the side to move's point of view
+ * @return true if the position is in the book
+ */
+bool probeOpeningBook(const Board& board, int& column, int& score) {
+    if (!g_bookEntries) return false;
+
+    bool mirrored;
+    std::uint64_t key = canonicalBookKey(board, mirrored);
+    std::uint64_t first = key << KEY_SHIFT;
+
+    const std::uint64_t* end = g_bookEntries + g_bookCount;
+    const std::uint64_t* it = std::lower_bound(g_bookEntries, end, first);
+    if (it == end || (*it >> KEY_SHIFT) != key) return false;
+
+    int stored = static_cast<int>((*it >> MOVE_SHIFT) & 7);
+    column = mirrored ? COLS - 1 - stored : stored;
+
+    // Sign-extend the 12-bit score
+    int code = static_cast<int>(*it & SCORE_MASK);
+    if (code & (1 << (MOVE_SHIFT - 1))) code -= (1 << MOVE_SHIFT);
+    score = decodeScore(code);
+    return true;
+}
@@ -0,0 +1,36 @@
+#ifndef OPENING_BOOK_H
+#define OPENING_BOOK_H
+
+#include "board.h"
+#include <cstdint>
+#include <vector>
+
+// Default location of the generated book (see `make book`)
+constexpr const char* OPENING_BOOK_PATH = "assets/opening_book.bin";
+
+// File layout: a 16-byte header followed by sorted 64-bit entries.
+// Each entry packs | key (49 bits) | best column (3 bits) | score (12 bits) |
+// with the key in the high bits, so sorting entries sorts by key.
+constexpr std::uint32_t BOOK_MAGIC = 0x4B423443; // "C4BK" read little-endian
+constexpr std::uint16_t BOOK_VERSION = 1;
+
+struct BookHeader {
+    std::uint32_t magic;
+    std::uint16_t version;
+    std::uint8_t maxPly;    // Deepest ply stored
+    std::uint8_t reserved;
+    std::uint64_t count;    // Number of entries
+};
+
+// Book lookup (used by the game)
+bool openOpeningBook(const char* path);
+void closeOpeningBook();
+bool isOpeningBookOpen();
+bool probeOpeningBook(const Board& board, int& column, int& score);
+
+// Book construction (used by the generator)
+std::uint64_t canonicalBookKey(const Board& board, bool& mirrored);
+std::uint64_t packBookEntry(std::uint64_t key, int column, int score);
+bool writeOpeningBook(const char* path, std::vector<std::uint64_t>& entries, int maxPly);
+
+#endif // OPENING_BOOK_H
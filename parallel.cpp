@@ -0,0 +1,91 @@
+#include "parallel.h"
+#include "trace.h"
+#include <algorithm>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// One worker's share of the task range. The owner takes tasks from the
+// front; idle workers steal the back half. Each queue sits on its own
+// cache line so owners never contend with each other.
+struct alignas(64) WorkQueue {
+    std::mutex lock;
+    int begin = 0;
+    int end = 0;
+};
+
+bool popOwn(WorkQueue& queue, int& task) {
+    std::lock_guard<std::mutex> guard(queue.lock);
+    if (queue.begin >= queue.end) return false;
+    task = queue.begin++;
+    return true;
+}
+
+bool stealHalf(WorkQueue& victim, WorkQueue& thief) {
+    int begin, end;
+    {
+        std::lock_guard<std::mutex> guard(victim.lock);
+        int remaining = victim.end - victim.begin;
+        if (remaining <= 0) return false;
+        int take = (remaining + 1) / 2;
+        end = victim.end;
+        begin = end - take;
+        victim.end = begin;
+    }
+    std::lock_guard<std::mutex> guard(thief.lock);
+    thief.begin = begin;
+    thief.end = end;
+    return true;
+}
+
+} // namespace
+
+/**
+ * @brief Number of hardware threads, never less than 1
+ */
+int hardwareThreads() {
+    unsigned count = std::thread::hardware_concurrency();
+    return count == 0 ? 1 : static_cast<int>(count);
+}
+
+/**
+ * @brief Run body(task, worker) for every task in [0, taskCount) on a work-stealing pool
+ * @param taskCount Number of tasks
+ * @param threadCount Worker threads to use (clamped to [1, taskCount])
+ * @param body Task body; worker is in [0, threadCount) and stable per thread
+ */
+void parallelFor(int taskCount, int threadCount, const ParallelTask& body) {
+    if (taskCount <= 0) return;
+    threadCount = std::max(1, std::min(threadCount, taskCount));
+
+    // Start with an even contiguous split; stealing rebalances uneven tasks
+    std::vector<WorkQueue> queues(threadCount);
+    for (int w = 0; w < threadCount; ++w) {
+        queues[w].begin = static_cast<int>(static_cast<long long>(taskCount) * w / threadCount);
+        queues[w].end = static_cast<int>(static_cast<long long>(taskCount) * (w + 1) / threadCount);
+    }
+
+    auto worker = [&](int self) {
+        if (self > 0) TRACE_THREAD_NAME("parallel_worker");
+        for (;;) {
+            int task;
+            if (popOwn(queues[self], task)) {
+                body(task, self);
+                continue;
+            }
+            // Tasks never spawn tasks, so once every queue is empty we are done
+            bool stole = false;
+            for (int i = 1; i < threadCount && !stole; ++i) {
+                stole = stealHalf(queues[(self + i) % threadCount], queues[self]);
+            }
+            if (!stole) return;
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int w = 1; w < threadCount; ++w) threads.emplace_back(worker, w);
+    worker(0);
+    for (std::thread& t : threads) t.join();
+}
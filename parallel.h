@@ -0,0 +1,13 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <functional>
+
+// Body of a parallel loop: receives the task index and the worker running it
+using ParallelTask = std::function<void(int task, int worker)>;
+
+// Parallel helpers
+int hardwareThreads();
+void parallelFor(int taskCount, int threadCount, const ParallelTask& body);
+
+#endif // PARALLEL_H
@@ -0,0 +1,196 @@
+// Perft-style game tree enumerator: counts positions and terminal states per ply.
+// Build with: make perft
+// Usage: connect4_perft [--depth N] [--threads T] [--board 6x7|7x8|connect5]
+//                       [--unique] [--hash-mb M]
+
+#include "board.h"
+#include "parallel.h"
+#include "rules.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr int MAX_PLIES = 64;  // Enough for every board variant
+constexpr int SPLIT_PLY = 3;   // Subtrees below this ply are the parallel tasks
+
+struct PerftConfig {
+    int depth = 8;
+    int threads = 0;           // 0 = all hardware threads
+    std::string board = "6x7";
+    bool unique = false;       // Also count distinct positions
+    std::size_t hashMegabytes = 256;
+};
+
+/**
+ * @brief Lock-free insert-only hash set of non-zero 64-bit position keys
+ *
+ * Open addressing with linear probing; a slot is claimed with a single
+ * compare-exchange from 0, so threads never block each other.
+ */
+class ConcurrentKeySet {
+public:
+    explicit ConcurrentKeySet(std::size_t megabytes) : overflowed(false) {
+        std::size_t count = 1024;
+        while (count * 2 * sizeof(std::atomic<std::uint64_t>) <= (megabytes << 20)) count *= 2;
+        slots = std::make_unique<std::atomic<std::uint64_t>[]>(count);
+        for (std::size_t i = 0; i < count; ++i) slots[i].store(0, std::memory_order_relaxed);
+        mask = count - 1;
+    }
+
+    /**
+     * @brief Add a key
+     * @return true if the key was not in the set yet
+     */
+    bool insert(std::uint64_t key) {
+        std::size_t index = static_cast<std::size_t>((key * 0x9E3779B97F4A7C15ull) >> 20) & mask;
+        for (std::size_t probes = 0; probes <= mask; ++probes, index = (index + 1) & mask) {
+            std::uint64_t current = slots[index].load(std::memory_order_relaxed);
+            if (current == key) return false;
+            if (current == 0) {
+                if (slots[index].compare_exchange_strong(current, key, std::memory_order_relaxed)) return true;
+                if (current == key) return false; // Another thread inserted the same key
+            }
+        }
+        overflowed.store(true, std::memory_order_relaxed);
+        return false;
+    }
+
+    bool hasOverflowed() const { return overflowed.load(std::memory_order_relaxed); }
+    std::size_t capacity() const { return mask + 1; }
+
+private:
+    std::unique_ptr<std::atomic<std::uint64_t>[]> slots;
+    std::size_t mask;
+    std::atomic<bool> overflowed;
+};
+
+// Per-ply counters, one block per worker
+struct alignas(64) PerftCounts {
+    std::uint64_t nodes[MAX_PLIES + 1] = {};    // Positions reached (counting every move order)
+    std::uint64_t terminal[MAX_PLIES + 1] = {}; // Of which a win or a full board
+    std::uint64_t unique[MAX_PLIES + 1] = {};   // Positions seen for the first time
+};
+
+/**
+ * @brief Count every child of a position, recursing until maxPly
+ * @param frontier If set, children at maxPly that are not terminal are collected here
+ */
+template <class B>
+void perft(const B& board, int player, int maxPly, ConcurrentKeySet* uniqueSet,
+           PerftCounts& counts, std::vector<B>* frontier) {
+    int ply = board.moves + 1;
+    for (int col = 0; col < B::COLS; ++col) {
+        if (!board.canPlay(col)) continue;
+        B child = board;
+        int row = dropPiece(child, col, player);
+
+        ++counts.nodes[ply];
+        if (uniqueSet && uniqueSet->insert(child.key())) ++counts.unique[ply];
+        if (checkWin(child, row, col) || checkDraw(child)) {
+            ++counts.terminal[ply];
+            continue;
+        }
+        if (ply < maxPly) perft(child, 3 - player, maxPly, uniqueSet, counts, frontier);
+        else if (frontier) frontier->push_back(child);
+    }
+}
+
+bool parseArgs(int argc, char* argv[], PerftConfig& config) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--depth" && hasValue) config.depth = std::atoi(argv[++i]);
+        else if (arg == "--threads" && hasValue) config.threads = std::atoi(argv[++i]);
+        else if (arg == "--board" && hasValue) config.board = argv[++i];
+        else if (arg == "--unique") config.unique = true;
+        else if (arg == "--hash-mb" && hasValue) config.hashMegabytes = std::strtoull(argv[++i], nullptr, 10);
+        else return false;
+    }
+    return config.depth >= 1;
+}
+
+/**
+ * @brief Run perft on one board variant and print a row per ply
+ */
+template <class B>
+int runPerft(const PerftConfig& config) {
+    int depth = config.depth < B::CELLS ? config.depth : B::CELLS;
+    int threads = config.threads > 0 ? config.threads : hardwareThreads();
+    std::unique_ptr<ConcurrentKeySet> uniqueSet;
+    if (config.unique) uniqueSet = std::make_unique<ConcurrentKeySet>(config.hashMegabytes);
+
+    std::printf("Perft %dx%d connect %d, depth %d, %d threads%s\n", B::ROWS, B::COLS, B::CONNECT,
+                depth, threads, uniqueSet ? ", counting unique positions" : "");
+
+    auto start = std::chrono::steady_clock::now();
+
+    // Expand the first plies on this thread, then search the subtrees in parallel
+    B root;
+    resetBoard(root);
+    PerftCounts rootCounts;
+    std::vector<B> frontier;
+    int splitPly = depth < SPLIT_PLY ? depth : SPLIT_PLY;
+    perft(root, 1, splitPly, uniqueSet.get(), rootCounts, depth > splitPly ? &frontier : nullptr);
+
+    std::vector<PerftCounts> counts(threads);
+    parallelFor(static_cast<int>(frontier.size()), threads, [&](int task, int worker) {
+        const B& board = frontier[task];
+        perft(board, 1 + (board.moves & 1), depth, uniqueSet.get(), counts[worker],
+              static_cast<std::vector<B>*>(nullptr));
+    });
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::uint64_t totalNodes = 0;
+    std::printf("%5s %16s %16s %16s\n", "ply", "nodes", "terminal", uniqueSet ? "unique" : "");
+    for (int ply = 1; ply <= depth; ++ply) {
+        std::uint64_t nodes = rootCounts.nodes[ply];
+        std::uint64_t terminal = rootCounts.terminal[ply];
+        std::uint64_t unique = rootCounts.unique[ply];
+        for (const PerftCounts& c : counts) {
+            nodes += c.nodes[ply];
+            terminal += c.terminal[ply];
+            unique += c.unique[ply];
+        }
+        totalNodes += nodes;
+        if (uniqueSet) {
+            std::printf("%5d %16llu %16llu %16llu\n", ply, static_cast<unsigned long long>(nodes),
+                        static_cast<unsigned long long>(terminal), static_cast<unsigned long long>(unique));
+        } else {
+            std::printf("%5d %16llu %16llu\n", ply, static_cast<unsigned long long>(nodes),
+                        static_cast<unsigned long long>(terminal));
+        }
+    }
+    std::printf("%llu nodes in %.3f s | %.1f M nodes/s\n", static_cast<unsigned long long>(totalNodes),
+                seconds, totalNodes / seconds / 1e6);
+
+    if (uniqueSet && uniqueSet->hasOverflowed()) {
+        std::fprintf(stderr, "Hash set full (%zu keys): unique counts are too low, raise --hash-mb\n",
+                     uniqueSet->capacity());
+        return 2;
+    }
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    PerftConfig config;
+    if (!parseArgs(argc, argv, config)) {
+        std::fprintf(stderr,
+                     "Usage: %s [--depth N] [--threads T] [--board 6x7|7x8|connect5]\n"
+                     "          [--unique] [--hash-mb M]\n",
+                     argv[0]);
+        return 1;
+    }
+    if (config.board == "6x7") return runPerft<Board>(config);
+    if (config.board == "7x8") return runPerft<Board7x8>(config);
+    if (config.board == "connect5") return runPerft<BoardConnect5>(config);
+    std::fprintf(stderr, "Unknown board %s\n", config.board.c_str());
+    return 1;
+}
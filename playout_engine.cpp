@@ -0,0 +1,207 @@
+#include "playout_engine.h"
+#include "rules.h"
+#include "trace.h"
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define PLAYOUT_HAS_AVX2_KERNEL 1
+#else
+#define PLAYOUT_HAS_AVX2_KERNEL 0
+#endif
+
+namespace {
+
+static_assert(Board::CONNECT == 4 && COLUMN_BITS == 7, "Line shifts assume the standard board");
+
+constexpr int VECTOR_LANES = 4; // 64-bit lanes per AVX2 register
+
+// Cells of each column (sentinel bit excluded)
+constexpr std::uint64_t columnMask(int col) {
+    return ((std::uint64_t(1) << ROWS) - 1) << (col * COLUMN_BITS);
+}
+
+/**
+ * @brief Whether a stone mask contains four in a row
+ *        Shift-and along each direction: vertical, horizontal and both diagonals.
+ */
+bool hasLine(std::uint64_t stones) {
+    constexpr int shifts[4] = {1, COLUMN_BITS, COLUMN_BITS - 1, COLUMN_BITS + 1};
+    std::uint64_t lines = 0;
+    for (int shift : shifts) {
+        std::uint64_t pairs = stones & (stones >> shift);
+        lines |= pairs & (pairs >> (2 * shift));
+    }
+    return lines != 0;
+}
+
+/**
+ * @brief Play one random ply in a lane
+ *        The move is the k-th playable column, k = (random * count) >> 32,
+ *        found by walking the columns in order exactly like the AVX2 kernel.
+ * @return Stones of the side that just moved
+ */
+std::uint64_t playRandomPly(std::uint64_t& mover, std::uint64_t& occupied, std::uint64_t& rng) {
+    rng ^= rng << 13;
+    rng ^= rng >> 7;
+    rng ^= rng << 17;
+
+    std::uint64_t playable = (occupied + Board::BOTTOM_MASK) & Board::BOARD_MASK;
+    std::uint64_t count = __builtin_popcountll(playable);
+    std::uint64_t pick = ((rng >> 32) * count) >> 32;
+    std::uint64_t move = 0;
+    for (int col = 0; col < COLS; ++col) {
+        std::uint64_t cell = playable & columnMask(col);
+        if (!cell) continue;
+        if (pick == 0) {
+            move = cell;
+            break;
+        }
+        --pick;
+    }
+
+    std::uint64_t stones = mover | move;
+    occupied |= move;
+    mover = occupied ^ stones; // The opponent moves next
+    return stones;
+}
+
+#if PLAYOUT_HAS_AVX2_KERNEL
+
+__attribute__((target("avx2"))) inline __m256i shiftAnd(__m256i stones, int shift) {
+    __m256i pairs = _mm256_and_si256(stones, _mm256_srl_epi64(stones, _mm_cvtsi32_si128(shift)));
+    return _mm256_and_si256(pairs, _mm256_srl_epi64(pairs, _mm_cvtsi32_si128(2 * shift)));
+}
+
+/**
+ * @brief Play one random ply in four lanes (same algorithm as playRandomPly)
+ * @return Bit i set if lane i just finished (line completed or board full)
+ */
+__attribute__((target("avx2"))) int playRandomPly4(std::uint64_t* moverLanes, std::uint64_t* occupiedLanes,
+                                                   std::uint64_t* rngLanes, int& wonMask) {
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i mover = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(moverLanes));
+    __m256i occupied = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(occupiedLanes));
+    __m256i rng = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rngLanes));
+
+    rng = _mm256_xor_si256(rng, _mm256_slli_epi64(rng, 13));
+    rng = _mm256_xor_si256(rng, _mm256_srli_epi64(rng, 7));
+    rng = _mm256_xor_si256(rng, _mm256_slli_epi64(rng, 17));
+
+    // Playable cell of each column, and how many columns are open
+    __m256i playable = _mm256_and_si256(
+        _mm256_add_epi64(occupied, _mm256_set1_epi64x(static_cast<long long>(Board::BOTTOM_MASK))),
+        _mm256_set1_epi64x(static_cast<long long>(Board::BOARD_MASK)));
+    __m256i cells[COLS];
+    __m256i open[COLS]; // All ones if the column is playable
+    __m256i count = zero;
+    for (int col = 0; col < COLS; ++col) {
+        cells[col] = _mm256_and_si256(playable, _mm256_set1_epi64x(static_cast<long long>(columnMask(col))));
+        open[col] = _mm256_xor_si256(_mm256_cmpeq_epi64(cells[col], zero), _mm256_set1_epi64x(-1));
+        count = _mm256_sub_epi64(count, open[col]);
+    }
+
+    // pick = (high 32 random bits * count) >> 32, then select the pick-th open column
+    __m256i pick = _mm256_srli_epi64(_mm256_mul_epu32(_mm256_srli_epi64(rng, 32), count), 32);
+    __m256i move = zero;
+    for (int col = 0; col < COLS; ++col) {
+        __m256i chosen = _mm256_and_si256(_mm256_cmpeq_epi64(pick, zero), open[col]);
+        move = _mm256_or_si256(move, _mm256_and_si256(cells[col], chosen));
+        pick = _mm256_add_epi64(pick, open[col]);
+    }
+
+    __m256i stones = _mm256_or_si256(mover, move);
+    occupied = _mm256_or_si256(occupied, move);
+    __m256i lines = _mm256_or_si256(_mm256_or_si256(shiftAnd(stones, 1), shiftAnd(stones, COLUMN_BITS)),
+                                    _mm256_or_si256(shiftAnd(stones, COLUMN_BITS - 1), shiftAnd(stones, COLUMN_BITS + 1)));
+    __m256i won = _mm256_xor_si256(_mm256_cmpeq_epi64(lines, zero), _mm256_set1_epi64x(-1));
+    __m256i full = _mm256_cmpeq_epi64(occupied, _mm256_set1_epi64x(static_cast<long long>(Board::BOARD_MASK)));
+
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(moverLanes), _mm256_xor_si256(occupied, stones));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(occupiedLanes), occupied);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(rngLanes), rng);
+    wonMask = _mm256_movemask_pd(_mm256_castsi256_pd(won));
+    return _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_or_si256(won, full)));
+}
+
+#endif // PLAYOUT_HAS_AVX2_KERNEL
+
+bool cpuHasAVX2() {
+#if PLAYOUT_HAS_AVX2_KERNEL
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+} // namespace
+
+PlayoutEngine::PlayoutEngine(int lanes, std::uint64_t seed, PlayoutKernel kernel)
+    : kernel(kernel), rootMover(0), rootOccupied(0) {
+    if (this->kernel != PLAYOUT_SCALAR) this->kernel = cpuHasAVX2() ? PLAYOUT_AVX2 : PLAYOUT_SCALAR;
+
+    int count = (std::max(lanes, 1) + VECTOR_LANES - 1) / VECTOR_LANES * VECTOR_LANES;
+    mover.assign(count, 0);
+    occupied.assign(count, 0);
+    rng.resize(count);
+    for (int lane = 0; lane < count; ++lane) {
+        rng[lane] = mixSeed(seed ^ mixSeed(static_cast<std::uint64_t>(lane))) | 1;
+    }
+}
+
+bool PlayoutEngine::setRoot(const Board& root) {
+    if (root.winner != 0 || root.isFull()) return false;
+    rootMover = root.pieces[root.moves & 1];
+    rootOccupied = root.occupied();
+    std::fill(mover.begin(), mover.end(), rootMover);
+    std::fill(occupied.begin(), occupied.end(), rootOccupied);
+    return true;
+}
+
+PlayoutTally PlayoutEngine::run(std::uint64_t games) {
+    TRACE_SCOPE("playouts");
+    PlayoutTally tally = {0, {0, 0, 0}, 0};
+    while (tally.games < games) {
+        if (kernel == PLAYOUT_AVX2) stepAVX2(tally);
+        else stepScalar(tally);
+        tally.plies += mover.size();
+    }
+    return tally;
+}
+
+/**
+ * @brief Tally a finished game and restart its lane from the root
+ */
+void PlayoutEngine::finishLane(int lane, bool won, PlayoutTally& tally) {
+    // Player 1 makes the odd-numbered plies
+    int lastMover = (__builtin_popcountll(occupied[lane]) & 1) ? 1 : 2;
+    ++tally.games;
+    ++tally.wins[won ? lastMover : 0];
+    mover[lane] = rootMover;
+    occupied[lane] = rootOccupied;
+}
+
+void PlayoutEngine::stepScalar(PlayoutTally& tally) {
+    int lanes = getLanes();
+    for (int lane = 0; lane < lanes; ++lane) {
+        std::uint64_t stones = playRandomPly(mover[lane], occupied[lane], rng[lane]);
+        bool won = hasLine(stones);
+        if (won || occupied[lane] == Board::BOARD_MASK) finishLane(lane, won, tally);
+    }
+}
+
+void PlayoutEngine::stepAVX2(PlayoutTally& tally) {
+#if PLAYOUT_HAS_AVX2_KERNEL
+    int lanes = getLanes();
+    for (int base = 0; base < lanes; base += VECTOR_LANES) {
+        int wonMask;
+        int finished = playRandomPly4(&mover[base], &occupied[base], &rng[base], wonMask);
+        for (; finished; finished &= finished - 1) {
+            int i = __builtin_ctz(finished);
+            finishLane(base + i, (wonMask >> i) & 1, tally);
+        }
+    }
+#else
+    stepScalar(tally);
+#endif
+}
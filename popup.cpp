@@ -1,4 +1,6 @@
 #include "popup.h"
+#include "layout.h"
+#include "text_cache.h"
 #include <algorithm>
 #include <cmath>
 
@@ -9,8 +11,6 @@ PopupState g_popup = {false, 0, 0.0f, ""};
 constexpr float FADE_SPEED = 600.0f;    // Alpha units per second
 constexpr float POPUP_WIDTH = 500.0f;
 constexpr float POPUP_HEIGHT = 250.0f;
-constexpr int WINDOW_WIDTH_POPUP = 700;  // Match main game window
-constexpr int WINDOW_HEIGHT_POPUP = 650;
 
 // Track restart button position for click detection
 static float g_restartButtonX = 0.0f;
@@ -55,22 +55,22 @@ void updatePopup(float deltaTime) {
  * @brief Draw the arcade-style winner popup overlay with sprite graphics
  * @param window SFML render window to draw on
  * @param font Font to use for text rendering (if needed)
- * @param uiTexture Texture containing UI sprite sheet
- * @param drawTexture Texture containing draw sprite
+ * @param uiImage Atlas region of the UI sprite sheet
+ * @param drawImage Atlas region of the draw sprite
  */
-void drawWinnerPopup(sf::RenderWindow& window, const sf::Font& font, const sf::Texture* uiTexture, const sf::Texture* drawTexture) {
+void drawWinnerPopup(sf::RenderWindow& window, const sf::Font& font, const AtlasRegion* uiImage, const AtlasRegion* drawImage) {
     if (!g_popup.isActive) return;
     
     std::uint8_t alpha = static_cast<std::uint8_t>(g_popup.alpha);
     
     // 1. Draw semi-transparent dark overlay over entire window (darker for drama)
-    sf::RectangleShape overlay(sf::Vector2f(WINDOW_WIDTH_POPUP, WINDOW_HEIGHT_POPUP));
+    sf::RectangleShape overlay(sf::Vector2f(WINDOW_WIDTH, WINDOW_HEIGHT));
     overlay.setFillColor(sf::Color(0, 0, 0, static_cast<std::uint8_t>(alpha * 0.85f)));
     window.draw(overlay);
     
     // 2. Draw larger popup box in center
-    float popupX = (WINDOW_WIDTH_POPUP - POPUP_WIDTH) / 2.0f;
-    float popupY = (WINDOW_HEIGHT_POPUP - POPUP_HEIGHT) / 2.0f - 20.0f;
+    float popupX = (WINDOW_WIDTH - POPUP_WIDTH) / 2.0f;
+    float popupY = (WINDOW_HEIGHT - POPUP_HEIGHT) / 2.0f - 20.0f;
     
     // Arcade-style background with double border
     sf::RectangleShape popupBg(sf::Vector2f(POPUP_WIDTH, POPUP_HEIGHT));
@@ -97,10 +97,10 @@ void drawWinnerPopup(sf::RenderWindow& window, const sf::Font& font, const sf::T
     window.draw(innerBorder);
     
     // 3. Draw "GAME OVER" sprite if texture is available
-    if (uiTexture) {
-        sf::Sprite gameOverSprite(*uiTexture);
+    if (uiImage) {
+        sf::Sprite gameOverSprite(*uiImage->texture);
         // SFML 3.x Fix: IntRect uses Vector2 for position and size
-        gameOverSprite.setTextureRect(sf::IntRect(sf::Vector2i(85, 465), sf::Vector2i(485, 100))); // GAME_OVER_RECT
+        gameOverSprite.setTextureRect(uiImage->rect(sf::IntRect(sf::Vector2i(85, 465), sf::Vector2i(485, 100)))); // GAME_OVER_RECT
         
         float scale = 0.8f;
         gameOverSprite.setScale(sf::Vector2f(scale, scale));
@@ -118,16 +118,8 @@ void drawWinnerPopup(sf::RenderWindow& window, const sf::Font& font, const sf::T
         window.draw(gameOverSprite);
     } else {
         // Fallback to text if sprite not available
-        sf::Text gameOverText(font, "GAME OVER");
-        gameOverText.setCharacterSize(56);
+        sf::Text& gameOverText = getCachedText(font, "GAME OVER", 56, sf::Text::Bold);
         gameOverText.setFillColor(sf::Color(255, 255, 255, alpha));
-        gameOverText.setStyle(sf::Text::Bold);
-        
-        sf::FloatRect gameOverBounds = gameOverText.getLocalBounds();
-        gameOverText.setOrigin(sf::Vector2f(
-            gameOverBounds.position.x + gameOverBounds.size.x / 2.0f,
-            gameOverBounds.position.y + gameOverBounds.size.y / 2.0f
-        ));
         
         float gameOverY = popupY + 70.0f;
         gameOverText.setPosition(sf::Vector2f(popupX + POPUP_WIDTH / 2.0f, gameOverY));
@@ -135,9 +127,9 @@ void drawWinnerPopup(sf::RenderWindow& window, const sf::Font& font, const sf::T
     }
     
     // 4. Draw "DRAW" sprite for draw case, otherwise draw decorative line separator
-    if (g_popup.winningPlayer == 0 && drawTexture) {
+    if (g_popup.winningPlayer == 0 && drawImage) {
         // Draw the draw sprite in place of separator
-        sf::Sprite drawSprite(*drawTexture);
+        sf::Sprite drawSprite(*drawImage->texture, drawImage->bounds());
         
         float scale = 0.5f; // Adjust scale as needed for nice appearance
         drawSprite.setScale(sf::Vector2f(scale, scale));
@@ -168,15 +160,18 @@ void drawWinnerPopup(sf::RenderWindow& window, const sf::Font& font, const sf::T
     }
     
     // 5. Draw winner announcement with neon effect
-    sf::Text winnerText(font, g_popup.message);
-    winnerText.setCharacterSize(40);
-    winnerText.setStyle(sf::Text::Bold);
+    // Laid out once per message; the shadow reuses the same glyphs
+    sf::Text& winnerText = getCachedText(font, g_popup.message, 40, sf::Text::Bold, 2.0f);
     
-    // Shadow for winner text
-    sf::Text winnerShadow(font, g_popup.message);
-    winnerShadow.setCharacterSize(40);
-    winnerShadow.setFillColor(sf::Color(0, 0, 0, static_cast<std::uint8_t>(alpha * 0.7f)));
-    winnerShadow.setStyle(sf::Text::Bold);
+    float winnerY = popupY + POPUP_HEIGHT / 2.0f + 20.0f;
+    winnerText.setPosition(sf::Vector2f(popupX + POPUP_WIDTH / 2.0f, winnerY));
+    
+    // Shadow: same text offset by 3px, outline hidden
+    winnerText.setFillColor(sf::Color(0, 0, 0, static_cast<std::uint8_t>(alpha * 0.7f)));
+    winnerText.setOutlineColor(sf::Color::Transparent);
+    sf::RenderStates shadowStates;
+    shadowStates.transform.translate(sf::Vector2f(3.0f, 3.0f));
+    window.draw(winnerText, shadowStates);
     
     // Set winner text color based on player
     if (g_popup.winningPlayer == 1) {
@@ -189,29 +184,15 @@ void drawWinnerPopup(sf::RenderWindow& window, const sf::Font& font, const sf::T
         winnerText.setFillColor(sf::Color(150, 220, 255, alpha)); // Light cyan
         winnerText.setOutlineColor(sf::Color(100, 200, 255, alpha));
     }
-    winnerText.setOutlineThickness(2.0f);
-    
-    sf::FloatRect winnerBounds = winnerText.getLocalBounds();
-    winnerText.setOrigin(sf::Vector2f(
-        winnerBounds.position.x + winnerBounds.size.x / 2.0f,
-        winnerBounds.position.y + winnerBounds.size.y / 2.0f
-    ));
-    winnerShadow.setOrigin(winnerText.getOrigin());
-    
-    float winnerY = popupY + POPUP_HEIGHT / 2.0f + 20.0f;
-    winnerText.setPosition(sf::Vector2f(popupX + POPUP_WIDTH / 2.0f, winnerY));
-    winnerShadow.setPosition(sf::Vector2f(popupX + POPUP_WIDTH / 2.0f + 3.0f, winnerY + 3.0f));
-    
-    window.draw(winnerShadow);
     window.draw(winnerText);
     
     // 6. Draw restart button sprite if texture is available
-    if (uiTexture) {
+    if (uiImage) {
         float pulseAlpha = alpha * (0.8f + 0.2f * std::sin(g_popup.alpha / 40.0f));
         
-        sf::Sprite restartSprite(*uiTexture);
+        sf::Sprite restartSprite(*uiImage->texture);
         // SFML 3.x Fix: IntRect uses Vector2 for position and size
-        restartSprite.setTextureRect(sf::IntRect(sf::Vector2i(190, 680), sf::Vector2i(275, 100))); // RESTART_RECT
+        restartSprite.setTextureRect(uiImage->rect(sf::IntRect(sf::Vector2i(190, 680), sf::Vector2i(275, 100)))); // RESTART_RECT
         
         float scale = 0.5f;
         restartSprite.setScale(sf::Vector2f(scale, scale));
@@ -238,18 +219,10 @@ void drawWinnerPopup(sf::RenderWindow& window, const sf::Font& font, const sf::T
     } else {
         // Fallback to text if sprite not available
         float pulseAlpha = alpha * (0.7f + 0.3f * std::sin(g_popup.alpha / 40.0f));
-        sf::Text restartText(font, ">> PRESS R TO RESTART <<");
-        restartText.setCharacterSize(22);
+        sf::Text& restartText = getCachedText(font, ">> PRESS R TO RESTART <<", 22, sf::Text::Bold, 1.5f);
         restartText.setFillColor(sf::Color(0, 255, 150, static_cast<std::uint8_t>(pulseAlpha)));
-        restartText.setStyle(sf::Text::Bold);
-        restartText.setOutlineThickness(1.5f);
         restartText.setOutlineColor(sf::Color(0, 200, 100, static_cast<std::uint8_t>(pulseAlpha)));
         
-        sf::FloatRect restartBounds = restartText.getLocalBounds();
-        restartText.setOrigin(sf::Vector2f(
-            restartBounds.position.x + restartBounds.size.x / 2.0f,
-            restartBounds.position.y + restartBounds.size.y / 2.0f
-        ));
         restartText.setPosition(sf::Vector2f(
             popupX + POPUP_WIDTH / 2.0f,
             popupY + POPUP_HEIGHT - 50.0f
@@ -2,6 +2,7 @@
 #define POPUP_H
 
 #include <SFML/Graphics.hpp>
+#include "asset_loader.h"
 #include <string>
 
 // Popup state structure
@@ -18,7 +19,7 @@ extern PopupState g_popup;
 // Popup functions
 void initPopup(int winningPlayer, bool isDraw = false);
 void updatePopup(float deltaTime);
-void drawWinnerPopup(sf::RenderWindow& window, const sf::Font& font, const sf::Texture* uiTexture = nullptr, const sf::Texture* drawTexture = nullptr);
+void drawWinnerPopup(sf::RenderWindow& window, const sf::Font& font, const AtlasRegion* uiImage = nullptr, const AtlasRegion* drawImage = nullptr);
 void resetPopup();
 bool isClickOnRestartButton(float x, float y);
 
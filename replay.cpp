@@ -0,0 +1,104 @@
+// Headless replay tool: verifies and re-scores archived games.
+// Build with: make replay
+// Usage: connect4_replay [--rescore OUT] FILE...
+
+#include "game_record.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+struct ReplayStats {
+    std::uint64_t games = 0;
+    std::uint64_t plies = 0;
+    std::uint64_t results[4] = {0, 0, 0, 0}; // Indexed by GameResult (recomputed)
+    std::uint64_t illegal = 0;               // Illegal move or play after the end
+    std::uint64_t mismatched = 0;            // Stored result differs from the replay
+};
+
+const char* const RESULT_NAMES[4] = {"unfinished", "red", "yellow", "draw"};
+
+/**
+ * @brief Replay every record of one archive
+ * @param rescored Optional writer receiving every legal game with its recomputed result
+ * @return false if the archive cannot be opened
+ */
+bool replayArchive(const char* path, ReplayStats& stats, GameRecordWriter* rescored) {
+    GameArchive archive;
+    if (!archive.open(path)) {
+        std::fprintf(stderr, "%s: not a game archive for a %dx%d board\n", path, ROWS, COLS);
+        return false;
+    }
+
+    GameRecord record;
+    for (const GameRecordView& view : archive) {
+        ++stats.games;
+        stats.plies += view.plies;
+        int result = replayGameRecord(view);
+        if (result < 0) {
+            ++stats.illegal;
+            continue;
+        }
+        ++stats.results[result];
+        if (result != view.result) ++stats.mismatched;
+
+        if (rescored) {
+            record.clear();
+            for (int ply = 0; ply < view.plies; ++ply) record.addMove(view.move(ply));
+            record.result = static_cast<std::uint8_t>(result);
+            rescored->write(record);
+        }
+    }
+
+    if (std::size_t trailing = archive.trailingBytes()) {
+        std::fprintf(stderr, "%s: %zu unreadable bytes after the last complete record\n", path, trailing);
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const char* rescorePath = nullptr;
+    std::vector<const char*> inputs;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--rescore") == 0 && i + 1 < argc) rescorePath = argv[++i];
+        else inputs.push_back(argv[i]);
+    }
+    if (inputs.empty()) {
+        std::fprintf(stderr, "Usage: %s [--rescore OUT] FILE...\n", argv[0]);
+        return 1;
+    }
+
+    GameRecordWriter rescored;
+    if (rescorePath && !rescored.open(rescorePath)) {
+        std::fprintf(stderr, "Cannot write %s\n", rescorePath);
+        return 1;
+    }
+
+    ReplayStats stats;
+    bool ok = true;
+    auto start = std::chrono::steady_clock::now();
+    for (const char* path : inputs) {
+        ok = replayArchive(path, stats, rescorePath ? &rescored : nullptr) && ok;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (rescorePath && !rescored.close()) {
+        std::fprintf(stderr, "Failed to write %s\n", rescorePath);
+        ok = false;
+    }
+
+    double games = stats.games ? static_cast<double>(stats.games) : 1.0;
+    std::printf("games %llu | avg plies %.1f | illegal %llu | result mismatches %llu\n",
+                static_cast<unsigned long long>(stats.games), stats.plies / games,
+                static_cast<unsigned long long>(stats.illegal),
+                static_cast<unsigned long long>(stats.mismatched));
+    for (int r = RESULT_RED_WINS; r <= RESULT_DRAW; ++r) {
+        std::printf("%-7s %.1f%%  ", RESULT_NAMES[r], 100.0 * stats.results[r] / games);
+    }
+    std::printf("%s %.1f%%\n", RESULT_NAMES[RESULT_UNFINISHED], 100.0 * stats.results[RESULT_UNFINISHED] / games);
+    std::printf("%.3f s | %.0f games/s\n", seconds, stats.games / seconds);
+    return ok && stats.illegal == 0 && stats.mismatched == 0 ? 0 : 2;
+}
@@ -0,0 +1,116 @@
+#include "rules.h"
+
+/**
+ * @brief Clear the board for a new game
+ */
+template <class B>
+void resetBoard(B& board) {
+    board.reset();
+}
+
+/**
+ * @brief Finds the lowest available row in a column and places the piece
+ * @param board Board to play on
+ * @param col Column index
+ * @param player Player number (1=Red, 2=Yellow)
+ * @return Screen row where the piece landed, or -1 if the move is illegal
+ */
+template <class B>
+int dropPiece(B& board, int col, int player) {
+    return board.drop(col, player);
+}
+
+/**
+ * @brief Checks whether the last move completed a line
+ *        The board records the winner as pieces are dropped, so this is O(1).
+ * @param board Board to inspect
+ * @param lastRow The row of the last piece placed
+ * @param lastCol The column of the last piece placed
+ * @return true if the last move resulted in a win, false otherwise
+ */
+template <class B>
+bool checkWin(const B& board, int lastRow, int lastCol) {
+    if (lastRow == -1) return false;
+
+    return board.winner != 0 && board.winner == board.cell(lastRow, lastCol);
+}
+
+/**
+ * @brief Checks for a draw condition (board is full)
+ */
+template <class B>
+bool checkDraw(const B& board) {
+    return board.isFull();
+}
+
+/**
+ * @brief Cells of every completed line through the last piece placed
+ *        Walks both ways along each direction from the piece; the sentinel
+ *        bits are never owned, so runs stop at the edges of the board.
+ * @return Mask in the board's bit layout, 0 if the piece completed no line
+ */
+template <class B>
+std::uint64_t winningCells(const B& board, int lastRow, int lastCol) {
+    int owner = (lastRow == -1) ? 0 : board.cell(lastRow, lastCol);
+    if (owner == 0) return 0;
+
+    std::uint64_t own = board.pieces[owner - 1];
+    std::uint64_t last = std::uint64_t(1) << (lastCol * B::COLUMN_BITS + (B::ROWS - 1 - lastRow));
+    const int shifts[4] = {1, B::COLUMN_BITS, B::COLUMN_BITS - 1, B::COLUMN_BITS + 1};
+    std::uint64_t cells = 0;
+    for (int shift : shifts) {
+        std::uint64_t line = last;
+        for (std::uint64_t b = last << shift; b & own; b <<= shift) line |= b;
+        for (std::uint64_t b = last >> shift; b & own; b >>= shift) line |= b;
+        if (__builtin_popcountll(line) >= B::CONNECT) cells |= line;
+    }
+    return cells;
+}
+
+/**
+ * @brief Pick a uniformly random playable column
+ * @return Column index, or -1 if the board is full
+ */
+template <class B>
+int randomLegalColumn(const B& board, std::uint64_t& rngState) {
+    int legal[B::COLS];
+    int count = 0;
+    for (int c = 0; c < B::COLS; ++c) {
+        if (board.canPlay(c)) legal[count++] = c;
+    }
+    if (count == 0) return -1;
+    return legal[nextRandom(rngState) % count];
+}
+
+/**
+ * @brief Play uniformly random moves until the game ends
+ * @param board Starting position (modified in place)
+ * @param firstPlayer Player to move first (1=Red, 2=Yellow)
+ * @param rngState Random generator state
+ * @return Winning player, or 0 for a draw
+ */
+template <class B>
+int playRandomGame(B& board, int firstPlayer, std::uint64_t& rngState) {
+    int player = firstPlayer;
+    while (!board.isFull()) {
+        int col = randomLegalColumn(board, rngState);
+        int row = dropPiece(board, col, player);
+        if (checkWin(board, row, col)) return player;
+        player = (player == 1) ? 2 : 1;
+    }
+    return 0;
+}
+
+// Explicit instantiations for every board variant
+#define INSTANTIATE_RULES(B) \
+    template void resetBoard<B>(B&); \
+    template int dropPiece<B>(B&, int, int); \
+    template bool checkWin<B>(const B&, int, int); \
+    template bool checkDraw<B>(const B&); \
+    template std::uint64_t winningCells<B>(const B&, int, int); \
+    template int randomLegalColumn<B>(const B&, std::uint64_t&); \
+    template int playRandomGame<B>(B&, int, std::uint64_t&);
+
+INSTANTIATE_RULES(Board)
+INSTANTIATE_RULES(Board7x8)
+INSTANTIATE_RULES(BoardConnect5)
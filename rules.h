@@ -0,0 +1,41 @@
+#ifndef RULES_H
+#define RULES_H
+
+#include "board.h"
+#include <cstdint>
+
+// Headless game rules shared by the SFML game and the command-line tools.
+// Nothing here depends on SFML.
+
+/**
+ * @brief Advance a xorshift64* generator and return the next value
+ * @param state Generator state (must be non-zero)
+ */
+inline std::uint64_t nextRandom(std::uint64_t& state) {
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 0x2545F4914F6CDD1Dull;
+}
+
+/**
+ * @brief SplitMix64 step, used to derive independent generator seeds
+ *        (per game, lane, thread or client) from one base seed
+ */
+inline std::uint64_t mixSeed(std::uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+// Rule functions, for every board variant in board.h (instantiated in rules.cpp)
+template <class B> void resetBoard(B& board);
+template <class B> int dropPiece(B& board, int col, int player);
+template <class B> bool checkWin(const B& board, int lastRow, int lastCol);
+template <class B> bool checkDraw(const B& board);
+template <class B> std::uint64_t winningCells(const B& board, int lastRow, int lastCol);
+template <class B> int randomLegalColumn(const B& board, std::uint64_t& rngState);
+template <class B> int playRandomGame(B& board, int firstPlayer, std::uint64_t& rngState);
+
+#endif // RULES_H
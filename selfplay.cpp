@@ -0,0 +1,275 @@
+// Headless self-play runner: plays N games across all hardware threads.
+// Build with: make selfplay
+// Usage: connect4_selfplay [--games N] [--threads T] [--red ai|mcts|random]
+//                          [--yellow ai|mcts|random] [--nodes N] [--playouts N] [--random-plies K]
+//                          [--seed S] [--tt-mb M] [--tt-policy always|depth] [--scaling]
+//                          [--record FILE] [--trace FILE]
+
+#include "ai.h"
+#include "game_record.h"
+#include "mcts.h"
+#include "parallel.h"
+#include "trace.h"
+#include "rules.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace {
+
+enum PlayerKind { PLAYER_RANDOM, PLAYER_AI, PLAYER_MCTS };
+
+const char* const KIND_NAMES[] = {"random", "ai", "mcts"};
+
+struct SelfPlayConfig {
+    int games = 10000;
+    int threads = 0;                 // 0 = all hardware threads
+    PlayerKind kinds[2] = {PLAYER_AI, PLAYER_AI};
+    std::uint64_t nodeLimit = 20000; // AI nodes per move
+    std::uint64_t playoutLimit = 2000; // MCTS playouts per move
+    int randomPlies = 4;             // Random opening plies so AI games differ
+    std::uint64_t seed = 1;
+    std::size_t tableMegabytes = 2;  // Transposition table per worker, wiped every game
+    TTReplacement tablePolicy = TT_REPLACE_DEPTH_AGE;
+    bool scaling = false;            // Repeat the batch with 1, 2, 4, ... threads
+    const char* recordPath = nullptr; // Archive every game of the final batch here
+    const char* tracePath = nullptr;  // Chrome trace of the run (needs make TRACE=1)
+};
+
+// Shared game archive; workers take the lock only to copy one record into its buffer
+struct RecordSink {
+    GameRecordWriter writer;
+    std::mutex lock;
+};
+
+// Per-worker counters, one cache line each so workers never share a line
+struct alignas(64) WorkerStats {
+    std::uint64_t wins[2] = {0, 0};
+    std::uint64_t draws = 0;
+    std::uint64_t plies = 0;
+    std::uint64_t playouts = 0; // MCTS playouts
+    double searchSeconds = 0.0; // Time spent in MCTS searches
+};
+
+// Per-worker generator state, also cache-line separated
+struct alignas(64) WorkerRng {
+    std::uint64_t state = 1;
+};
+
+bool parseKind(const char* text, PlayerKind& kind) {
+    if (std::strcmp(text, "ai") == 0) kind = PLAYER_AI;
+    else if (std::strcmp(text, "mcts") == 0) kind = PLAYER_MCTS;
+    else if (std::strcmp(text, "random") == 0) kind = PLAYER_RANDOM;
+    else return false;
+    return true;
+}
+
+bool parseArgs(int argc, char* argv[], SelfPlayConfig& config) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--games" && hasValue) config.games = std::atoi(argv[++i]);
+        else if (arg == "--threads" && hasValue) config.threads = std::atoi(argv[++i]);
+        else if (arg == "--red" && hasValue) { if (!parseKind(argv[++i], config.kinds[0])) return false; }
+        else if (arg == "--yellow" && hasValue) { if (!parseKind(argv[++i], config.kinds[1])) return false; }
+        else if (arg == "--nodes" && hasValue) config.nodeLimit = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--playouts" && hasValue) config.playoutLimit = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--random-plies" && hasValue) config.randomPlies = std::atoi(argv[++i]);
+        else if (arg == "--seed" && hasValue) config.seed = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--tt-mb" && hasValue) config.tableMegabytes = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--tt-policy" && hasValue) {
+            std::string policy = argv[++i];
+            if (policy == "always") config.tablePolicy = TT_REPLACE_ALWAYS;
+            else if (policy == "depth") config.tablePolicy = TT_REPLACE_DEPTH_AGE;
+            else return false;
+        }
+        else if (arg == "--scaling") config.scaling = true;
+        else if (arg == "--record" && hasValue) config.recordPath = argv[++i];
+        else if (arg == "--trace" && hasValue) config.tracePath = argv[++i];
+        else return false;
+    }
+    return config.games > 0 && config.playoutLimit > 0;
+}
+
+/**
+ * @brief Play one complete game and record its outcome in the worker's stats
+ * @param mcts The worker's tree search (reseeded from the game's generator)
+ * @param table The worker's transposition table (wiped so earlier games leave no trace)
+ * @param record Receives the moves and result
+ */
+void playGame(const SelfPlayConfig& config, std::uint64_t& rng, MCTSSearch& mcts, TranspositionTable& table,
+              WorkerStats& stats, GameRecord& record) {
+    TRACE_SCOPE("selfplay_game");
+    Board board;
+    resetBoard(board);
+    record.clear();
+    mcts.setSeed(rng);
+    table.clear();
+    int player = 1;
+    for (;;) {
+        int col;
+        if (board.moves < config.randomPlies || config.kinds[player - 1] == PLAYER_RANDOM) {
+            col = randomLegalColumn(board, rng);
+        } else if (config.kinds[player - 1] == PLAYER_MCTS) {
+            MCTSResult result = mcts.search(board, player, {0.0, config.playoutLimit});
+            stats.playouts += result.playouts;
+            stats.searchSeconds += result.seconds;
+            col = result.column;
+        } else {
+            AIConfig search = {AI_MAX_DEPTH, config.nodeLimit};
+            search.table = &table;
+            col = searchBestMove(board, player, search).column;
+        }
+        int row = dropPiece(board, col, player);
+        record.addMove(col);
+        if (checkWin(board, row, col)) {
+            ++stats.wins[player - 1];
+            record.result = (player == 1) ? RESULT_RED_WINS : RESULT_YELLOW_WINS;
+            break;
+        }
+        if (checkDraw(board)) {
+            ++stats.draws;
+            record.result = RESULT_DRAW;
+            break;
+        }
+        player = (player == 1) ? 2 : 1;
+    }
+    stats.plies += board.moves;
+}
+
+/**
+ * @brief Run the whole batch on the given number of threads
+ * @param tables One transposition table per worker (at least threads of them)
+ * @param sink Archive for the games, or nullptr to discard them
+ * @return Wall-clock seconds taken
+ */
+double runBatch(const SelfPlayConfig& config, int threads,
+                const std::vector<std::unique_ptr<TranspositionTable>>& tables, WorkerStats& total,
+                RecordSink* sink) {
+    std::vector<WorkerStats> stats(threads);
+    std::vector<WorkerRng> rngs(threads);
+    // One single-threaded tree per worker; every expansion is one arena run of at most COLS nodes
+    std::vector<std::unique_ptr<MCTSSearch>> searchers;
+    bool usesMCTS = config.kinds[0] == PLAYER_MCTS || config.kinds[1] == PLAYER_MCTS;
+    for (int w = 0; w < threads; ++w) {
+        searchers.emplace_back(new MCTSSearch(usesMCTS ? (config.playoutLimit + 64) * COLS : 1));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    parallelFor(config.games, threads, [&](int game, int worker) {
+        // Reseed from the game index and start from an empty table so results
+        // do not depend on which worker happened to run (or steal) the game
+        std::uint64_t& rng = rngs[worker].state;
+        rng = mixSeed(config.seed ^ mixSeed(static_cast<std::uint64_t>(game))) | 1;
+        GameRecord record;
+        playGame(config, rng, *searchers[worker], *tables[worker], stats[worker], record);
+        if (sink) {
+            std::lock_guard<std::mutex> guard(sink->lock);
+            sink->writer.write(record);
+        }
+    });
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    total = WorkerStats();
+    for (const WorkerStats& s : stats) {
+        total.wins[0] += s.wins[0];
+        total.wins[1] += s.wins[1];
+        total.draws += s.draws;
+        total.plies += s.plies;
+        total.playouts += s.playouts;
+        total.searchSeconds += s.searchSeconds;
+    }
+    return seconds;
+}
+
+void printSummary(const SelfPlayConfig& config, int threads, const WorkerStats& total, double seconds) {
+    double games = static_cast<double>(config.games);
+    std::printf("threads %3d | games %d | red %.1f%% | yellow %.1f%% | draw %.1f%% | "
+                "avg plies %.1f | %.2f s | %.0f games/s\n",
+                threads, config.games,
+                100.0 * total.wins[0] / games, 100.0 * total.wins[1] / games,
+                100.0 * total.draws / games, total.plies / games,
+                seconds, games / seconds);
+    if (total.playouts) {
+        // Per thread: playouts over time spent searching; total: playouts over
+        // wall-clock time, so idle or oversubscribed workers show up
+        double perThread = total.playouts / total.searchSeconds;
+        std::printf("            | mcts %.0f playouts/s per thread | %.0f playouts/s total\n",
+                    perThread, total.playouts / seconds);
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    SelfPlayConfig config;
+    TRACE_THREAD_NAME("main");
+    if (!parseArgs(argc, argv, config)) {
+        std::fprintf(stderr,
+                     "Usage: %s [--games N] [--threads T] [--red ai|mcts|random] [--yellow ai|mcts|random]\n"
+                     "          [--nodes N] [--playouts N] [--random-plies K] [--seed S] [--tt-mb M]\n"
+                     "          [--tt-policy always|depth] [--scaling] [--record FILE] [--trace FILE]\n",
+                     argv[0]);
+        return 1;
+    }
+
+    int maxThreads = config.threads > 0 ? config.threads : hardwareThreads();
+    // Private tables keep concurrent games from evicting each other's entries
+    std::vector<std::unique_ptr<TranspositionTable>> tables;
+    bool usesAI = config.kinds[0] == PLAYER_AI || config.kinds[1] == PLAYER_AI;
+    for (int w = 0; w < maxThreads; ++w) {
+        tables.emplace_back(new TranspositionTable());
+        if (usesAI && !tables[w]->resize(config.tableMegabytes, config.tablePolicy)) {
+            std::fprintf(stderr, "Failed to allocate a %zu MB transposition table\n", config.tableMegabytes);
+            return 1;
+        }
+    }
+    std::printf("Self-play: red=%s yellow=%s nodes/move=%llu playouts/move=%llu random plies=%d "
+                "table=%zu KB per worker%s\n",
+                KIND_NAMES[config.kinds[0]], KIND_NAMES[config.kinds[1]],
+                static_cast<unsigned long long>(config.nodeLimit),
+                static_cast<unsigned long long>(config.playoutLimit), config.randomPlies,
+                tables[0]->sizeBytes() >> 10, tables[0]->usesHugePages() ? " (huge pages)" : "");
+
+    RecordSink sink;
+    if (config.recordPath && !sink.writer.open(config.recordPath)) {
+        std::fprintf(stderr, "Cannot append games to %s\n", config.recordPath);
+        return 1;
+    }
+
+    WorkerStats total;
+    if (config.scaling) {
+        for (int threads = 1; threads < maxThreads; threads *= 2) {
+            double seconds = runBatch(config, threads, tables, total, nullptr);
+            printSummary(config, threads, total, seconds);
+        }
+    }
+    double seconds = runBatch(config, maxThreads, tables, total, config.recordPath ? &sink : nullptr);
+    printSummary(config, maxThreads, total, seconds);
+
+    if (config.recordPath) {
+        if (!sink.writer.close()) {
+            std::fprintf(stderr, "Failed to write %s\n", config.recordPath);
+            return 1;
+        }
+        std::printf("Recorded %llu games to %s\n",
+                    static_cast<unsigned long long>(sink.writer.recordsWritten()), config.recordPath);
+    }
+
+    if (config.tracePath) {
+        if (!TRACE_ENABLED) {
+            std::fprintf(stderr, "Tracing is not compiled in; rebuild with make TRACE=1\n");
+        } else if (!writeTrace(config.tracePath)) {
+            std::fprintf(stderr, "Failed to write %s\n", config.tracePath);
+            return 1;
+        } else {
+            std::printf("Trace written to %s\n", config.tracePath);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,549 @@
+// Headless match server: hosts many games at once over TCP (Linux, epoll).
+// Build with: make server
+// Usage: connect4_server [--port P] [--threads T] [--nodes N] [--max-matches M] [--cache BASE | --no-cache]
+//
+// One thread runs the epoll loop: it accepts connections, parses the line
+// protocol in match_protocol.h, applies the client's moves and owns every
+// match. Server replies (AI moves) are searched by a pool of worker threads
+// on a copy of the board and handed back through a queue plus an eventfd,
+// so a slow search never stalls the other connections. Solved positions are
+// kept in the on-disk cache (solved_cache.h) so a restart starts warm.
+
+#include "ai.h"
+#include "match_protocol.h"
+#include "parallel.h"
+#include "rules.h"
+#include "solved_cache.h"
+#include "trace.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <condition_variable>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <string>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+struct ServerConfig {
+    int port = MATCH_DEFAULT_PORT;
+    int threads = 0;                // AI workers, 0 = all hardware threads
+    std::uint64_t nodeLimit = 2000; // Search nodes per server move
+    int maxMatches = 65536;         // Match pool capacity
+    const char* cachePath = SOLVED_CACHE_PATH; // nullptr = no solved-position cache
+};
+
+constexpr std::uint32_t NO_MATCH = 0xFFFFFFFFu;
+constexpr int MAX_EVENTS = 256;
+constexpr int LISTEN_BACKLOG = 1024;
+
+volatile std::sig_atomic_t g_stopRequested = 0;
+
+void onStopSignal(int) {
+    g_stopRequested = 1;
+}
+
+// Fixed pool of boards, one per running match, recycled through a free list.
+// Only the event loop thread touches it.
+struct MatchPool {
+    std::vector<Board> boards;
+    std::vector<std::uint32_t> freeSlots;
+
+    void init(int capacity) {
+        boards.resize(capacity);
+        freeSlots.resize(capacity);
+        for (int i = 0; i < capacity; ++i) freeSlots[i] = static_cast<std::uint32_t>(capacity - 1 - i);
+    }
+
+    std::uint32_t acquire() {
+        if (freeSlots.empty()) return NO_MATCH;
+        std::uint32_t slot = freeSlots.back();
+        freeSlots.pop_back();
+        resetBoard(boards[slot]);
+        return slot;
+    }
+
+    void release(std::uint32_t slot) {
+        freeSlots.push_back(slot);
+    }
+
+    std::size_t active() const {
+        return boards.size() - freeSlots.size();
+    }
+};
+
+struct Connection {
+    int fd = -1;
+    std::uint32_t generation = 0; // Bumped on every accept so replies for a closed socket are dropped
+    std::uint32_t match = NO_MATCH;
+    bool busy = false;            // The server's reply is being searched
+    int clientColumn = -1;        // Client move waiting for the server's reply
+    bool writeArmed = false;      // EPOLLOUT registered because output is pending
+    std::string input;
+    std::string output;
+};
+
+// Server move to search; the board is a copy so workers never touch the pool
+struct AIJob {
+    int fd;
+    std::uint32_t generation;
+    Board board;
+};
+
+struct AIReply {
+    int fd;
+    std::uint32_t generation;
+    int column;
+};
+
+struct ServerStats {
+    std::uint64_t connections = 0;
+    std::uint64_t matchesStarted = 0;
+    std::uint64_t matchesFinished = 0;
+    std::size_t peakMatches = 0; // Most matches running at once
+    std::uint64_t moves = 0;
+    std::uint64_t errors = 0;
+};
+
+/**
+ * @brief Worker threads that search server moves
+ */
+class AIWorkers {
+public:
+    AIWorkers(int threads, std::uint64_t nodeLimit, int wakeFd) : nodeLimit(nodeLimit), wakeFd(wakeFd) {
+        for (int t = 0; t < threads; ++t) workers.emplace_back([this] { run(); });
+    }
+
+    ~AIWorkers() {
+        {
+            std::lock_guard<std::mutex> guard(jobLock);
+            stopping = true;
+        }
+        jobReady.notify_all();
+        for (std::thread& worker : workers) worker.join();
+    }
+
+    void submit(const AIJob& job) {
+        {
+            std::lock_guard<std::mutex> guard(jobLock);
+            jobs.push_back(job);
+        }
+        jobReady.notify_one();
+    }
+
+    /**
+     * @brief Move every finished reply into out (called by the event loop)
+     */
+    void takeReplies(std::vector<AIReply>& out) {
+        std::lock_guard<std::mutex> guard(replyLock);
+        out.swap(replies);
+        replies.clear();
+    }
+
+private:
+    void run() {
+        TRACE_THREAD_NAME("server_ai");
+        for (;;) {
+            AIJob job;
+            {
+                std::unique_lock<std::mutex> guard(jobLock);
+                jobReady.wait(guard, [this] { return stopping || !jobs.empty(); });
+                if (jobs.empty()) return;
+                job = jobs.front();
+                jobs.pop_front();
+            }
+            int column = searchBestMove(job.board, 2, {AI_MAX_DEPTH, nodeLimit}).column;
+            {
+                std::lock_guard<std::mutex> guard(replyLock);
+                replies.push_back({job.fd, job.generation, column});
+            }
+            std::uint64_t one = 1;
+            if (write(wakeFd, &one, sizeof(one)) < 0) {
+                // The counter only saturates if the loop stopped reading; nothing to do
+            }
+        }
+    }
+
+    std::uint64_t nodeLimit;
+    int wakeFd;
+    std::vector<std::thread> workers;
+    std::mutex jobLock;
+    std::condition_variable jobReady;
+    std::deque<AIJob> jobs;
+    bool stopping = false;
+    std::mutex replyLock;
+    std::vector<AIReply> replies;
+};
+
+/**
+ * @brief Single-threaded epoll loop owning every connection and match
+ */
+class MatchServer {
+public:
+    MatchServer(const ServerConfig& config, int listenFd, int epollFd, int wakeFd)
+        : listenFd(listenFd), epollFd(epollFd), wakeFd(wakeFd),
+          workers(config.threads, config.nodeLimit, wakeFd) {
+        matches.init(config.maxMatches);
+    }
+
+    void run() {
+        epoll_event events[MAX_EVENTS];
+        std::vector<AIReply> replies;
+        while (!g_stopRequested) {
+            int count = epoll_wait(epollFd, events, MAX_EVENTS, 500);
+            if (count < 0) {
+                if (errno == EINTR) continue;
+                std::perror("epoll_wait");
+                return;
+            }
+            for (int i = 0; i < count; ++i) {
+                int fd = events[i].data.fd;
+                if (fd == listenFd) {
+                    acceptAll();
+                } else if (fd == wakeFd) {
+                    std::uint64_t ignored;
+                    if (read(wakeFd, &ignored, sizeof(ignored)) < 0) {
+                        // Spurious wake-up; the replies are drained below anyway
+                    }
+                    workers.takeReplies(replies);
+                    for (const AIReply& reply : replies) finishServerMove(reply);
+                } else {
+                    handleClient(fd, events[i].events);
+                }
+            }
+        }
+        for (Connection& conn : connections) {
+            if (conn.fd >= 0) closeConnection(conn);
+        }
+    }
+
+    const ServerStats& getStats() const {
+        return stats;
+    }
+
+private:
+    void acceptAll() {
+        for (;;) {
+            int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) {
+                if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) std::perror("accept4");
+                return;
+            }
+            int noDelay = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+            if (static_cast<std::size_t>(fd) >= connections.size()) connections.resize(fd + 1);
+            Connection& conn = connections[fd];
+            conn.fd = fd;
+            ++conn.generation;
+            conn.match = NO_MATCH;
+            conn.busy = false;
+            conn.writeArmed = false;
+            conn.input.clear();
+            conn.output.clear();
+
+            epoll_event event = {};
+            event.events = EPOLLIN | EPOLLRDHUP;
+            event.data.fd = fd;
+            epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event);
+            ++stats.connections;
+        }
+    }
+
+    void handleClient(int fd, std::uint32_t eventMask) {
+        Connection& conn = connections[fd];
+        if (conn.fd < 0) return; // Closed earlier in this batch of events
+        if (eventMask & (EPOLLERR | EPOLLHUP)) {
+            closeConnection(conn);
+            return;
+        }
+        if (eventMask & (EPOLLIN | EPOLLRDHUP)) {
+            char buffer[4096];
+            for (;;) {
+                ssize_t got = recv(fd, buffer, sizeof(buffer), 0);
+                if (got > 0) {
+                    conn.input.append(buffer, static_cast<std::size_t>(got));
+                    continue;
+                }
+                if (got < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+                if (got < 0 && errno == EINTR) continue;
+                closeConnection(conn); // Peer closed or failed
+                return;
+            }
+            if (!processLines(conn)) return;
+        }
+        if (eventMask & EPOLLOUT) flush(conn);
+    }
+
+    /**
+     * @brief Handle every complete line in the input buffer
+     * @return false if the connection was closed
+     */
+    bool processLines(Connection& conn) {
+        std::size_t start = 0;
+        for (;;) {
+            std::size_t end = conn.input.find('\n', start);
+            if (end == std::string::npos) break;
+            std::string line = conn.input.substr(start, end - start);
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            start = end + 1;
+            if (!handleCommand(conn, line)) return false;
+        }
+        conn.input.erase(0, start);
+        if (conn.input.size() > MATCH_MAX_LINE) {
+            closeConnection(conn);
+            return false;
+        }
+        flush(conn);
+        return conn.fd >= 0;
+    }
+
+    /**
+     * @brief Execute one protocol command
+     * @return false if the connection was closed
+     */
+    bool handleCommand(Connection& conn, const std::string& line) {
+        if (line == "NEW") {
+            if (conn.busy) return reply(conn, "ERR busy\n");
+            if (conn.match != NO_MATCH) matches.release(conn.match); // Abandon the old match
+            conn.match = matches.acquire();
+            if (conn.match == NO_MATCH) return reply(conn, "ERR full\n");
+            ++stats.matchesStarted;
+            stats.peakMatches = std::max(stats.peakMatches, matches.active());
+            return reply(conn, "OK\n");
+        }
+        if (line.compare(0, 5, "MOVE ") == 0) {
+            if (conn.match == NO_MATCH) return reply(conn, "ERR no-match\n");
+            if (conn.busy) return reply(conn, "ERR busy\n");
+            char* endPtr = nullptr;
+            long col = std::strtol(line.c_str() + 5, &endPtr, 10);
+            Board& board = matches.boards[conn.match];
+            if (endPtr == line.c_str() + 5 || *endPtr != '\0' || col < 0 || col >= COLS ||
+                !board.canPlay(static_cast<int>(col))) {
+                return reply(conn, "ERR illegal\n");
+            }
+
+            int column = static_cast<int>(col);
+            int row = dropPiece(board, column, 1);
+            ++stats.moves;
+            if (checkWin(board, row, column)) return endMatch(conn, column, -1, MATCH_RED_WINS);
+            if (checkDraw(board)) return endMatch(conn, column, -1, MATCH_DRAW);
+
+            conn.busy = true;
+            conn.clientColumn = column;
+            workers.submit({conn.fd, conn.generation, board});
+            return true;
+        }
+        if (line == "QUIT") {
+            closeConnection(conn);
+            return false;
+        }
+        return reply(conn, "ERR unknown\n");
+    }
+
+    /**
+     * @brief Apply a searched server move and answer the client
+     */
+    void finishServerMove(const AIReply& result) {
+        if (result.fd < 0 || static_cast<std::size_t>(result.fd) >= connections.size()) return;
+        Connection& conn = connections[result.fd];
+        if (conn.fd < 0 || conn.generation != result.generation || !conn.busy) return; // Client left meanwhile
+        conn.busy = false;
+
+        Board& board = matches.boards[conn.match];
+        int row = dropPiece(board, result.column, 2);
+        ++stats.moves;
+        MatchState state = MATCH_PLAYING;
+        if (checkWin(board, row, result.column)) state = MATCH_YELLOW_WINS;
+        else if (checkDraw(board)) state = MATCH_DRAW;
+
+        if (state != MATCH_PLAYING) {
+            endMatch(conn, conn.clientColumn, result.column, state);
+        } else {
+            sendMoved(conn, conn.clientColumn, result.column, state);
+        }
+        flush(conn);
+    }
+
+    bool endMatch(Connection& conn, int clientColumn, int serverColumn, MatchState state) {
+        matches.release(conn.match);
+        conn.match = NO_MATCH;
+        ++stats.matchesFinished;
+        return sendMoved(conn, clientColumn, serverColumn, state);
+    }
+
+    bool sendMoved(Connection& conn, int clientColumn, int serverColumn, MatchState state) {
+        char line[48];
+        std::snprintf(line, sizeof(line), "MOVED %d %d %s\n", clientColumn, serverColumn, MATCH_STATE_NAMES[state]);
+        return reply(conn, line);
+    }
+
+    bool reply(Connection& conn, const char* line) {
+        if (std::strncmp(line, "ERR", 3) == 0) ++stats.errors;
+        conn.output += line;
+        return true;
+    }
+
+    /**
+     * @brief Send as much pending output as the socket takes; wait for EPOLLOUT for the rest
+     */
+    void flush(Connection& conn) {
+        while (!conn.output.empty()) {
+            ssize_t sent = send(conn.fd, conn.output.data(), conn.output.size(), MSG_NOSIGNAL);
+            if (sent > 0) {
+                conn.output.erase(0, static_cast<std::size_t>(sent));
+            } else if (sent < 0 && errno == EINTR) {
+                continue;
+            } else if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                break;
+            } else {
+                closeConnection(conn);
+                return;
+            }
+        }
+        bool wantWrite = !conn.output.empty();
+        if (wantWrite != conn.writeArmed) {
+            epoll_event event = {};
+            event.events = EPOLLIN | EPOLLRDHUP | (wantWrite ? EPOLLOUT : 0u);
+            event.data.fd = conn.fd;
+            epoll_ctl(epollFd, EPOLL_CTL_MOD, conn.fd, &event);
+            conn.writeArmed = wantWrite;
+        }
+    }
+
+    void closeConnection(Connection& conn) {
+        if (conn.match != NO_MATCH) matches.release(conn.match);
+        conn.match = NO_MATCH;
+        conn.busy = false;
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, conn.fd, nullptr);
+        close(conn.fd);
+        conn.fd = -1;
+        conn.input.clear();
+        conn.output.clear();
+    }
+
+    int listenFd;
+    int epollFd;
+    int wakeFd;
+    MatchPool matches;
+    std::vector<Connection> connections; // Indexed by socket descriptor
+    ServerStats stats;
+    AIWorkers workers;                   // Declared last: joined before the rest is destroyed
+};
+
+bool parseArgs(int argc, char* argv[], ServerConfig& config) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--port" && hasValue) config.port = std::atoi(argv[++i]);
+        else if (arg == "--threads" && hasValue) config.threads = std::atoi(argv[++i]);
+        else if (arg == "--nodes" && hasValue) config.nodeLimit = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--max-matches" && hasValue) config.maxMatches = std::atoi(argv[++i]);
+        else if (arg == "--cache" && hasValue) config.cachePath = argv[++i];
+        else if (arg == "--no-cache") config.cachePath = nullptr;
+        else return false;
+    }
+    return config.port > 0 && config.port < 65536 && config.maxMatches > 0;
+}
+
+int openListenSocket(int port) {
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    int reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(static_cast<std::uint16_t>(port));
+    if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || listen(fd, LISTEN_BACKLOG) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    ServerConfig config;
+    if (!parseArgs(argc, argv, config)) {
+        std::fprintf(stderr, "Usage: %s [--port P] [--threads T] [--nodes N] [--max-matches M] [--cache BASE | --no-cache]\n",
+                     argv[0]);
+        return 1;
+    }
+    if (config.threads <= 0) config.threads = hardwareThreads();
+
+    int listenFd = openListenSocket(config.port);
+    if (listenFd < 0) {
+        std::perror("listen");
+        return 1;
+    }
+    int epollFd = epoll_create1(EPOLL_CLOEXEC);
+    int wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epollFd < 0 || wakeFd < 0) {
+        std::perror("epoll/eventfd");
+        return 1;
+    }
+    epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = listenFd;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &event);
+    event.data.fd = wakeFd;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &event);
+
+    struct sigaction action = {};
+    action.sa_handler = onStopSignal;
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    clearAITable();
+    if (config.cachePath && !openSolvedCache(config.cachePath)) {
+        std::fprintf(stderr, "Cannot open the solved-position cache %s, continuing without it\n", config.cachePath);
+    }
+    if (isSolvedCacheOpen()) {
+        SolvedCacheStats cache = getSolvedCacheStats();
+        std::printf("Solved-position cache %s: %llu positions\n", config.cachePath,
+                    static_cast<unsigned long long>(cache.indexed + cache.logged));
+    }
+    std::printf("Serving on port %d: %d AI threads, %llu nodes/move, up to %d matches (Ctrl+C to stop)\n",
+                config.port, config.threads, static_cast<unsigned long long>(config.nodeLimit), config.maxMatches);
+    std::fflush(stdout);
+
+    ServerStats stats;
+    {
+        MatchServer server(config, listenFd, epollFd, wakeFd);
+        server.run();
+        stats = server.getStats();
+    }
+    std::printf("Connections %llu | matches started %llu, finished %llu, peak %zu | moves %llu | errors %llu\n",
+                static_cast<unsigned long long>(stats.connections),
+                static_cast<unsigned long long>(stats.matchesStarted),
+                static_cast<unsigned long long>(stats.matchesFinished), stats.peakMatches,
+                static_cast<unsigned long long>(stats.moves),
+                static_cast<unsigned long long>(stats.errors));
+    if (isSolvedCacheOpen()) {
+        SolvedCacheStats cache = getSolvedCacheStats();
+        std::printf("Solved-position cache: %llu hits, %llu new positions\n",
+                    static_cast<unsigned long long>(cache.hits), static_cast<unsigned long long>(cache.stores));
+        closeSolvedCache(); // The workers are joined, so the log can be compacted
+    }
+
+    close(wakeFd);
+    close(epollFd);
+    close(listenFd);
+    return 0;
+}
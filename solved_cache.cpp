@@ -0,0 +1,527 @@
+#include "solved_cache.h"
+#include "mapped_file.h"
+#include "opening_book.h"
+#include "trace.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+
+struct SolvedLogHeader {
+    std::uint32_t magic;
+    std::uint16_t version;
+    std::uint8_t rows;  // Board size the positions belong to
+    std::uint8_t cols;
+};
+
+struct SolvedIndexHeader {
+    std::uint32_t magic;
+    std::uint16_t version;
+    std::uint8_t rows;
+    std::uint8_t cols;
+    std::uint32_t slotBits; // The index has 1 << slotBits slots
+    std::uint32_t count;    // Occupied slots
+};
+
+static_assert(sizeof(SolvedRecord) == 16 && sizeof(SolvedIndexHeader) == 16, "Cache files use fixed layouts");
+
+constexpr std::uint32_t MIN_SLOT_BITS = 4;
+
+// Records solved since the last compaction, readable without locks. Each
+// slot is two atomic words written as data and key XOR data, like the
+// transposition table, so a torn read fails the check and reads as a miss.
+// Records beyond half its slots are only logged, and found after the next compaction.
+constexpr std::uint32_t RECENT_SLOT_BITS = 15;
+constexpr std::uint64_t RECENT_SLOTS = std::uint64_t(1) << RECENT_SLOT_BITS;
+static_assert(2 * SOLVED_COMPACT_RECORDS <= RECENT_SLOTS, "A log of minimum trigger length must stay probeable");
+constexpr std::uint64_t RECENT_USED = std::uint64_t(1) << 40; // Set in the data word of every filled slot
+
+/**
+ * @brief One index snapshot: the mapped file, or a table built in memory
+ *        by a compaction that ran while searches were probing
+ */
+struct SolvedIndex {
+    MappedFile file;
+    std::vector<SolvedRecord> built;
+    const SolvedRecord* slots;
+    std::uint32_t slotBits;
+    std::uint64_t count;
+};
+
+struct alignas(64) ReaderCount {
+    std::atomic<std::uint32_t> readers{0};
+};
+
+struct RecentSlot {
+    std::atomic<std::uint64_t> check{0};
+    std::atomic<std::uint64_t> data{0};
+};
+
+// Two snapshots: searches probe the active one while a compaction prepares
+// the other, publishes it and waits for the readers of the old one to leave
+SolvedIndex g_indexes[2] = {{{nullptr, 0, nullptr}, {}, nullptr, 0, 0}, {{nullptr, 0, nullptr}, {}, nullptr, 0, 0}};
+std::atomic<int> g_activeIndex(0);
+ReaderCount g_indexReaders[2];
+
+RecentSlot g_recent[RECENT_SLOTS];
+
+// Log of records solved since the last compaction (writers hold g_logLock)
+std::mutex g_logLock;
+std::FILE* g_log = nullptr;
+std::vector<SolvedRecord> g_logged;
+std::unordered_set<std::uint64_t> g_loggedKeys;
+std::uint64_t g_recentCount = 0;
+
+// Compactions run on their own thread, so a search that stores a record never
+// waits for the index rewrite. g_compactLock serialises compactions; the
+// request and stop flags are guarded by g_logLock.
+std::mutex g_compactLock;
+std::thread g_compactor;
+std::condition_variable g_compactWake;
+bool g_compactRequested = false;
+bool g_compactorStop = false;
+
+std::string g_basePath;
+std::atomic<bool> g_open(false);
+std::atomic<std::uint64_t> g_hits(0);
+std::atomic<std::uint64_t> g_stores(0);
+
+std::string indexPath() {
+    return g_basePath + ".idx";
+}
+
+std::string logPath() {
+    return g_basePath + ".log";
+}
+
+std::uint64_t slotFor(std::uint64_t key, std::uint32_t slotBits) {
+    return (key * 0x9E3779B97F4A7C15ull) >> (64 - slotBits);
+}
+
+/**
+ * @brief Holds the active index snapshot so a compaction cannot free it mid-probe
+ */
+class IndexReader {
+public:
+    IndexReader() {
+        for (;;) {
+            slot = g_activeIndex.load();
+            g_indexReaders[slot].readers.fetch_add(1);
+            if (g_activeIndex.load() == slot) return;
+            g_indexReaders[slot].readers.fetch_sub(1); // Swapped meanwhile: take the new one
+        }
+    }
+    ~IndexReader() {
+        g_indexReaders[slot].readers.fetch_sub(1, std::memory_order_release);
+    }
+    IndexReader(const IndexReader&) = delete;
+    IndexReader& operator=(const IndexReader&) = delete;
+
+    const SolvedIndex& index() const {
+        return g_indexes[slot];
+    }
+
+private:
+    int slot;
+};
+
+const SolvedRecord* findIndexed(const SolvedIndex& index, std::uint64_t key) {
+    if (!index.slots) return nullptr;
+    std::uint64_t mask = (std::uint64_t(1) << index.slotBits) - 1;
+    std::uint64_t i = slotFor(key, index.slotBits);
+    // Bounded so a corrupt file without empty slots cannot spin forever
+    for (std::uint64_t probes = 0; probes <= mask; ++probes, i = (i + 1) & mask) {
+        if (index.slots[i].key == key) return &index.slots[i];
+        if (index.slots[i].key == SOLVED_EMPTY_KEY) return nullptr;
+    }
+    return nullptr;
+}
+
+bool findRecent(std::uint64_t key, SolvedRecord& record) {
+    for (std::uint64_t i = slotFor(key, RECENT_SLOT_BITS);; i = (i + 1) & (RECENT_SLOTS - 1)) {
+        std::uint64_t data = g_recent[i].data.load(std::memory_order_relaxed);
+        if (!data) return false;
+        if ((g_recent[i].check.load(std::memory_order_relaxed) ^ data) != key) continue;
+        record = {key, static_cast<std::int32_t>(data & 0xFFFFFFFF), static_cast<std::int8_t>(data >> 32), {0, 0, 0}};
+        return true;
+    }
+}
+
+/**
+ * @brief Add a record to the lock-free table (caller holds g_logLock)
+ * @return false if the key is already there
+ */
+bool insertRecent(const SolvedRecord& record) {
+    std::uint64_t data = static_cast<std::uint32_t>(record.score) |
+                         (static_cast<std::uint64_t>(static_cast<std::uint8_t>(record.column)) << 32) | RECENT_USED;
+    for (std::uint64_t i = slotFor(record.key, RECENT_SLOT_BITS);; i = (i + 1) & (RECENT_SLOTS - 1)) {
+        std::uint64_t existing = g_recent[i].data.load(std::memory_order_relaxed);
+        if (existing && (g_recent[i].check.load(std::memory_order_relaxed) ^ existing) == record.key) return false;
+        if (!existing) {
+            g_recent[i].check.store(record.key ^ data, std::memory_order_relaxed);
+            g_recent[i].data.store(data, std::memory_order_relaxed);
+            ++g_recentCount;
+            return true;
+        }
+    }
+}
+
+void clearRecent() {
+    for (RecentSlot& slot : g_recent) {
+        slot.data.store(0, std::memory_order_relaxed);
+        slot.check.store(0, std::memory_order_relaxed);
+    }
+    g_recentCount = 0;
+}
+
+/**
+ * @brief Remember a logged record, and make it probeable while the recent table has room
+ *        (caller holds g_logLock)
+ */
+void addLogged(const SolvedRecord& record) {
+    if (g_recentCount < RECENT_SLOTS / 2) insertRecent(record);
+    g_logged.push_back(record);
+    g_loggedKeys.insert(record.key);
+}
+
+/**
+ * @brief Log length that triggers a compaction: a quarter of the index, so
+ *        the total rewrite work stays linear in the number of records
+ *        (caller holds g_logLock)
+ */
+std::uint64_t compactThreshold() {
+    return std::max(SOLVED_COMPACT_RECORDS, g_indexes[g_activeIndex.load()].count / 4);
+}
+
+/**
+ * @brief Map the index file into a snapshot, if there is a valid one
+ */
+void mapIndex(SolvedIndex& index) {
+    if (!openMappedFile(index.file, indexPath().c_str())) return;
+
+    SolvedIndexHeader header;
+    if (index.file.size >= sizeof(header)) std::memcpy(&header, index.file.data, sizeof(header));
+    if (index.file.size < sizeof(header) || header.magic != SOLVED_INDEX_MAGIC || header.version != SOLVED_VERSION ||
+        header.rows != ROWS || header.cols != COLS || header.slotBits < MIN_SLOT_BITS || header.slotBits > 40 ||
+        index.file.size != sizeof(header) + (std::uint64_t(1) << header.slotBits) * sizeof(SolvedRecord) ||
+        header.count > (std::uint64_t(1) << header.slotBits) / 2) {
+        closeMappedFile(index.file);
+        return;
+    }
+    // The header is 16 bytes, so the records stay 8-byte aligned
+    index.slots = reinterpret_cast<const SolvedRecord*>(index.file.data + sizeof(header));
+    index.slotBits = header.slotBits;
+    index.count = header.count;
+}
+
+void releaseIndex(SolvedIndex& index) {
+    closeMappedFile(index.file);
+    std::vector<SolvedRecord>().swap(index.built);
+    index.slots = nullptr;
+    index.slotBits = 0;
+    index.count = 0;
+}
+
+/**
+ * @brief Wait until no probe is using a snapshot (probes take well under a microsecond)
+ */
+void drainReaders(int slot) {
+    // Sequentially consistent, pairing with IndexReader's increment and recheck
+    while (g_indexReaders[slot].readers.load() != 0) std::this_thread::yield();
+}
+
+/**
+ * @brief Load the records of an existing log (a missing or foreign log is ignored)
+ */
+void readLog() {
+    std::FILE* in = std::fopen(logPath().c_str(), "rb");
+    if (!in) return;
+    SolvedLogHeader header;
+    if (std::fread(&header, sizeof(header), 1, in) == 1 && header.magic == SOLVED_LOG_MAGIC &&
+        header.version == SOLVED_VERSION && header.rows == ROWS && header.cols == COLS) {
+        // A torn record at the end (crash mid-append) is dropped by the whole-record read
+        std::unordered_map<std::uint64_t, SolvedRecord> unique;
+        SolvedRecord record;
+        while (std::fread(&record, sizeof(record), 1, in) == 1) unique[record.key] = record;
+        for (const auto& entry : unique) g_logged.push_back(entry.second);
+    }
+    std::fclose(in);
+}
+
+/**
+ * @brief Start a new log holding only the records from `first` on, and keep
+ *        it open for appending (caller holds g_logLock)
+ * @param first Records before it are in the index by now
+ */
+bool resetLog(std::size_t first) {
+    std::vector<SolvedRecord> kept(g_logged.begin() + first, g_logged.end());
+    g_logged.clear();
+    g_loggedKeys.clear();
+    clearRecent();
+
+    if (g_log) std::fclose(g_log);
+    g_log = std::fopen(logPath().c_str(), "wb");
+    if (!g_log) return false;
+    SolvedLogHeader header = {SOLVED_LOG_MAGIC, SOLVED_VERSION, ROWS, COLS};
+    bool ok = std::fwrite(&header, sizeof(header), 1, g_log) == 1;
+    for (const SolvedRecord& record : kept) {
+        ok = ok && std::fwrite(&record, sizeof(SolvedRecord), 1, g_log) == 1;
+        addLogged(record);
+    }
+    return ok && std::fflush(g_log) == 0;
+}
+
+/**
+ * @brief Close the log and drop every record and snapshot (caller holds g_logLock)
+ */
+void releaseAll() {
+    if (g_log) std::fclose(g_log);
+    g_log = nullptr;
+    g_logged.clear();
+    g_loggedKeys.clear();
+    clearRecent();
+    releaseIndex(g_indexes[0]);
+    releaseIndex(g_indexes[1]);
+}
+
+/**
+ * @brief Merge the index and the log into a new index file, then drop the
+ *        merged records from the log. The table is built and written without
+ *        g_logLock, so searches keep probing and storing throughout.
+ */
+bool compact() {
+    std::lock_guard<std::mutex> compacting(g_compactLock);
+    std::vector<SolvedRecord> merged;
+    int active;
+    {
+        std::lock_guard<std::mutex> guard(g_logLock);
+        if (!g_log) return false;
+        merged = g_logged;
+        active = g_activeIndex.load();
+    }
+
+    // Only compactions replace the active snapshot, so it stays valid here
+    const SolvedIndex& current = g_indexes[active];
+    std::unordered_set<std::uint64_t> logged;
+    for (const SolvedRecord& record : merged) logged.insert(record.key);
+
+    std::vector<SolvedRecord> records;
+    records.reserve(current.count + merged.size());
+    if (current.slots) {
+        for (std::uint64_t i = 0; i < (std::uint64_t(1) << current.slotBits); ++i) {
+            if (current.slots[i].key != SOLVED_EMPTY_KEY && !logged.count(current.slots[i].key)) {
+                records.push_back(current.slots[i]);
+            }
+        }
+    }
+    records.insert(records.end(), merged.begin(), merged.end());
+
+    std::uint32_t slotBits = MIN_SLOT_BITS;
+    while ((std::uint64_t(1) << slotBits) < 2 * records.size()) ++slotBits;
+    SolvedRecord empty = {SOLVED_EMPTY_KEY, 0, -1, {0, 0, 0}};
+    std::vector<SolvedRecord> slots(std::uint64_t(1) << slotBits, empty);
+    std::uint64_t mask = slots.size() - 1;
+    for (const SolvedRecord& record : records) {
+        std::uint64_t i = slotFor(record.key, slotBits);
+        while (slots[i].key != SOLVED_EMPTY_KEY) i = (i + 1) & mask;
+        slots[i] = record;
+    }
+
+    // Write beside the old index and swap it in, so a crash never leaves a half-written index
+    std::string finalPath = indexPath();
+    std::string tempPath = finalPath + ".tmp";
+    std::FILE* out = std::fopen(tempPath.c_str(), "wb");
+    if (!out) return false;
+    SolvedIndexHeader header = {SOLVED_INDEX_MAGIC, SOLVED_VERSION, ROWS, COLS, slotBits,
+                                static_cast<std::uint32_t>(records.size())};
+    bool ok = std::fwrite(&header, sizeof(header), 1, out) == 1 &&
+              std::fwrite(slots.data(), sizeof(SolvedRecord), slots.size(), out) == slots.size();
+    if (std::fclose(out) != 0 || !ok) {
+        std::remove(tempPath.c_str());
+        return false;
+    }
+
+    // Serve the new table from memory, then retire the old snapshot once its readers are gone
+    std::lock_guard<std::mutex> guard(g_logLock);
+    int next = 1 - active;
+    drainReaders(next);
+    releaseIndex(g_indexes[next]);
+    g_indexes[next].built = std::move(slots);
+    g_indexes[next].slots = g_indexes[next].built.data();
+    g_indexes[next].slotBits = slotBits;
+    g_indexes[next].count = records.size();
+    g_activeIndex.store(next);
+    drainReaders(active);
+    releaseIndex(g_indexes[active]); // Windows cannot replace a mapped file
+
+    if (std::rename(tempPath.c_str(), finalPath.c_str()) != 0) {
+        std::remove(finalPath.c_str());
+        if (std::rename(tempPath.c_str(), finalPath.c_str()) != 0) return false;
+    }
+    // Records stored during the rewrite stay in the log for the next compaction
+    return resetLog(merged.size());
+}
+
+/**
+ * @brief Background thread: compacts whenever a store asks for it
+ */
+void runCompactor() {
+    TRACE_THREAD_NAME("solved_cache");
+    std::unique_lock<std::mutex> guard(g_logLock);
+    for (;;) {
+        g_compactWake.wait(guard, [] { return g_compactRequested || g_compactorStop; });
+        if (g_compactorStop) return;
+        guard.unlock();
+        compact();
+        guard.lock();
+        g_compactRequested = false;
+    }
+}
+
+} // namespace
+
+/**
+ * @brief Open (or create) the cache files and map the index
+ *        A long log left by earlier runs is compacted first.
+ * @param basePath Path without extension; ".idx" and ".log" are appended
+ * @return false if the log cannot be written (the cache stays closed)
+ */
+bool openSolvedCache(const char* basePath) {
+    closeSolvedCache();
+    bool compactNow;
+    {
+        std::lock_guard<std::mutex> guard(g_logLock);
+        g_basePath = basePath;
+        mapIndex(g_indexes[g_activeIndex.load()]);
+        readLog();
+        // Rewrite the records read so far so the log is valid even if it was foreign or torn
+        if (!resetLog(0)) {
+            releaseAll();
+            return false;
+        }
+        compactNow = g_logged.size() >= compactThreshold();
+        g_compactRequested = false;
+        g_compactorStop = false;
+    }
+    if (compactNow && !compact()) {
+        std::lock_guard<std::mutex> guard(g_logLock);
+        releaseAll();
+        return false;
+    }
+    g_compactor = std::thread(runCompactor);
+    g_open.store(true, std::memory_order_release);
+    return true;
+}
+
+/**
+ * @brief Compact the log into the index and close both files
+ *        (no search may be running)
+ */
+void closeSolvedCache() {
+    if (!g_open.exchange(false)) return;
+    {
+        std::lock_guard<std::mutex> guard(g_logLock);
+        g_compactorStop = true;
+    }
+    g_compactWake.notify_one();
+    g_compactor.join();
+
+    bool pending;
+    {
+        std::lock_guard<std::mutex> guard(g_logLock);
+        pending = !g_logged.empty();
+    }
+    if (pending) compact();
+    std::lock_guard<std::mutex> guard(g_logLock);
+    releaseAll();
+}
+
+bool isSolvedCacheOpen() {
+    return g_open.load(std::memory_order_acquire);
+}
+
+/**
+ * @brief Merge the log into the index now (searches may keep running)
+ */
+bool compactSolvedCache() {
+    if (!isSolvedCacheOpen()) return false;
+    return compact();
+}
+
+/**
+ * @brief Look a position up in the index, then in the records logged since it
+ *        was built (never takes a lock)
+ * @param board Position (side to move from the move count)
+ * @param column Best column for the side to move
+ * @param score Exact score from the side to move's point of view
+ * @return true if the position has been solved before
+ */
+bool probeSolvedCache(const Board& board, int& column, int& score) {
+    if (!isSolvedCacheOpen()) return false;
+
+    bool mirrored;
+    std::uint64_t key = canonicalBookKey(board, mirrored);
+    SolvedRecord record;
+    bool found;
+    {
+        IndexReader reader;
+        const SolvedRecord* indexed = findIndexed(reader.index(), key);
+        found = indexed != nullptr;
+        if (found) record = *indexed;
+    }
+    // A compaction moving records from the recent table to the index can
+    // make a probe miss both; that only costs a search
+    if (!found && !findRecent(key, record)) return false;
+
+    column = mirrored ? COLS - 1 - record.column : record.column;
+    score = record.score;
+    g_hits.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+/**
+ * @brief Append a solved position to the log (ignored if it is already known)
+ *        Once the log reaches compactThreshold() records the background thread
+ *        merges it into the index, so long-running processes keep it bounded.
+ * @param board Position (side to move from the move count)
+ * @param column Best column for the side to move
+ * @param score Exact score from the side to move's point of view
+ */
+void storeSolvedPosition(const Board& board, int column, int score) {
+    if (!isSolvedCacheOpen()) return;
+
+    bool mirrored;
+    std::uint64_t key = canonicalBookKey(board, mirrored);
+    SolvedRecord record = {key, score, static_cast<std::int8_t>(mirrored ? COLS - 1 - column : column), {0, 0, 0}};
+    {
+        IndexReader reader;
+        if (findIndexed(reader.index(), key)) return;
+    }
+
+    std::lock_guard<std::mutex> guard(g_logLock);
+    if (!g_log || findIndexed(g_indexes[g_activeIndex.load()], key)) return; // Compacted in meanwhile
+    if (g_loggedKeys.count(key)) return;
+    // Flushed per record: solved positions are rare and should survive a crash
+    if (std::fwrite(&record, sizeof(record), 1, g_log) != 1 || std::fflush(g_log) != 0) return;
+    addLogged(record);
+    g_stores.fetch_add(1, std::memory_order_relaxed);
+    if (!g_compactRequested && g_logged.size() >= compactThreshold()) {
+        g_compactRequested = true;
+        g_compactWake.notify_one();
+    }
+}
+
+SolvedCacheStats getSolvedCacheStats() {
+    std::lock_guard<std::mutex> guard(g_logLock);
+    return {g_indexes[g_activeIndex.load()].count, g_logged.size(), g_hits.load(std::memory_order_relaxed),
+            g_stores.load(std::memory_order_relaxed)};
+}
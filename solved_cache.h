@@ -0,0 +1,51 @@
+#ifndef SOLVED_CACHE_H
+#define SOLVED_CACHE_H
+
+#include "board.h"
+#include <cstdint>
+
+// Positions the AI has solved (forced win/loss or a draw searched to the
+// end), kept across runs. New results are appended to a log file; on open,
+// on close and whenever the log reaches a quarter of the index (at least
+// SOLVED_COMPACT_RECORDS records) it is merged into a hash index (memory-mapped
+// on open), so a restarted process answers solved positions without searching
+// them again. Probes never lock, and stores never wait for a merge: those run
+// on a background thread.
+// Files: <base>.idx (index) and <base>.log (records not yet compacted).
+
+constexpr const char* SOLVED_CACHE_PATH = "solved_cache";
+constexpr std::uint64_t SOLVED_COMPACT_RECORDS = 4096; // Shortest log that triggers a compaction
+
+// Log layout: an 8-byte header followed by 16-byte records appended as they are solved.
+// Index layout: a 16-byte header followed by a power-of-two array of 16-byte
+// records, linear probing, at most half full; empty slots have key SOLVED_EMPTY_KEY.
+constexpr std::uint32_t SOLVED_LOG_MAGIC = 0x4C533443;   // "C4SL" read little-endian
+constexpr std::uint32_t SOLVED_INDEX_MAGIC = 0x49533443; // "C4SI" read little-endian
+constexpr std::uint16_t SOLVED_VERSION = 1;
+constexpr std::uint64_t SOLVED_EMPTY_KEY = ~std::uint64_t(0);
+
+struct SolvedRecord {
+    std::uint64_t key;   // Canonical (mirror-folded) position key
+    std::int32_t score;  // Exact score for the side to move
+    std::int8_t column;  // Best column in canonical orientation
+    std::uint8_t reserved[3];
+};
+
+struct SolvedCacheStats {
+    std::uint64_t indexed; // Positions in the mapped index
+    std::uint64_t logged;  // Positions in the log, not yet compacted
+    std::uint64_t hits;
+    std::uint64_t stores;
+};
+
+// Cache functions (probe, store and compaction are thread-safe; open and
+// close must not overlap with running searches)
+bool openSolvedCache(const char* basePath);
+void closeSolvedCache();
+bool isSolvedCacheOpen();
+bool compactSolvedCache();
+bool probeSolvedCache(const Board& board, int& column, int& score);
+void storeSolvedPosition(const Board& board, int column, int score);
+SolvedCacheStats getSolvedCacheStats();
+
+#endif // SOLVED_CACHE_H
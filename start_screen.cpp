@@ -1,8 +1,6 @@
 #include "start_screen.h"
-
-// Constants for window size (matching main game)
-constexpr int WINDOW_WIDTH = 700;
-constexpr int WINDOW_HEIGHT = 650;
+#include "layout.h"
+#include <algorithm>
 
 // Sprite regions from start_screen.png
 // Based on the sprite sheet layout, approximate coordinates:
@@ -22,7 +20,7 @@ static sf::FloatRect g_exitButtonBounds;
 /**
  * @brief Draw the start screen with title and menu buttons as separate sprites
  */
-void drawStartScreen(sf::RenderWindow& window, const sf::Texture* startTexture) {
+void drawStartScreen(sf::RenderWindow& window, const AtlasRegion* startImage) {
     // Draw checkered background pattern
     constexpr int CHECKER_SIZE = 20; // Size of each checker square
     const sf::Color GRAY1(100, 100, 100);      // Light gray
@@ -44,14 +42,14 @@ void drawStartScreen(sf::RenderWindow& window, const sf::Texture* startTexture)
         }
     }
     
-    if (!startTexture) {
+    if (!startImage) {
         // Fallback if texture not loaded - just show checkered background
         return;
     }
     
     // --- Draw Title Sprite ---
-    sf::Sprite titleSprite(*startTexture);
-    titleSprite.setTextureRect(TITLE_RECT);
+    sf::Sprite titleSprite(*startImage->texture);
+    titleSprite.setTextureRect(startImage->rect(TITLE_RECT));
     
     float titleScale = 0.8f;
     titleSprite.setScale(sf::Vector2f(titleScale, titleScale));
@@ -66,8 +64,8 @@ void drawStartScreen(sf::RenderWindow& window, const sf::Texture* startTexture)
     window.draw(titleSprite);
     
     // --- Draw Start Button Sprite ---
-    sf::Sprite startBtnSprite(*startTexture);
-    startBtnSprite.setTextureRect(START_BTN_RECT);
+    sf::Sprite startBtnSprite(*startImage->texture);
+    startBtnSprite.setTextureRect(startImage->rect(START_BTN_RECT));
     
     float startScale = 0.75f;
     startBtnSprite.setScale(sf::Vector2f(startScale, startScale));
@@ -85,8 +83,8 @@ void drawStartScreen(sf::RenderWindow& window, const sf::Texture* startTexture)
     window.draw(startBtnSprite);
     
     // --- Draw Exit Button Sprite ---
-    sf::Sprite exitBtnSprite(*startTexture);
-    exitBtnSprite.setTextureRect(EXIT_BTN_RECT);
+    sf::Sprite exitBtnSprite(*startImage->texture);
+    exitBtnSprite.setTextureRect(startImage->rect(EXIT_BTN_RECT));
     
     float exitScale = 0.6f;
     exitBtnSprite.setScale(sf::Vector2f(exitScale, exitScale));
@@ -104,6 +102,28 @@ void drawStartScreen(sf::RenderWindow& window, const sf::Texture* startTexture)
     window.draw(exitBtnSprite);
 }
 
+/**
+ * @brief Draw a progress bar on a plain background while assets load
+ */
+void drawLoadingScreen(sf::RenderWindow& window, float progress) {
+    constexpr float BAR_WIDTH = 400.0f;
+    constexpr float BAR_HEIGHT = 16.0f;
+    float barX = (WINDOW_WIDTH - BAR_WIDTH) / 2.0f;
+    float barY = (WINDOW_HEIGHT - BAR_HEIGHT) / 2.0f;
+    
+    sf::RectangleShape track(sf::Vector2f(BAR_WIDTH, BAR_HEIGHT));
+    track.setPosition(sf::Vector2f(barX, barY));
+    track.setFillColor(sf::Color(70, 70, 70));
+    track.setOutlineThickness(2.0f);
+    track.setOutlineColor(sf::Color(100, 100, 100));
+    window.draw(track);
+    
+    sf::RectangleShape fill(sf::Vector2f(BAR_WIDTH * std::clamp(progress, 0.0f, 1.0f), BAR_HEIGHT));
+    fill.setPosition(sf::Vector2f(barX, barY));
+    fill.setFillColor(sf::Color(0, 0, 150)); // Board blue
+    window.draw(fill);
+}
+
 /**
  * @brief Check if a mouse click is on the START button
  */
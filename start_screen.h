@@ -2,13 +2,22 @@
 #define START_SCREEN_H
 
 #include <SFML/Graphics.hpp>
+#include "asset_loader.h"
 
 /**
  * @brief Draw the start screen with title and menu buttons
  * @param window SFML render window to draw on
- * @param startTexture Texture containing the start screen sprite
+ * @param startImage Atlas region of the start screen sprite (nullptr if missing)
  */
-void drawStartScreen(sf::RenderWindow& window, const sf::Texture* startTexture);
+void drawStartScreen(sf::RenderWindow& window, const AtlasRegion* startImage);
+
+/**
+ * @brief Draw the placeholder shown while assets load in the background
+ *        Uses plain shapes only, since neither textures nor the font exist yet.
+ * @param window SFML render window to draw on
+ * @param progress Fraction of loading completed (0 to 1)
+ */
+void drawLoadingScreen(sf::RenderWindow& window, float progress);
 
 /**
  * @brief Check if a mouse click is on the START button
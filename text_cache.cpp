@@ -0,0 +1,45 @@
+#include "text_cache.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct TextCacheEntry {
+    const sf::Font* font;
+    std::string content;
+    unsigned characterSize;
+    std::uint32_t style;
+    float outlineThickness;
+    std::unique_ptr<sf::Text> text; // Heap-allocated so references stay valid as the cache grows
+};
+
+// A handful of strings are ever on screen, so a linear scan beats hashing
+// and lets lookups compare in place without building a key
+std::vector<TextCacheEntry> g_textCache;
+
+} // namespace
+
+sf::Text& getCachedText(const sf::Font& font, std::string_view content, unsigned characterSize,
+                        std::uint32_t style, float outlineThickness) {
+    for (TextCacheEntry& entry : g_textCache) {
+        if (entry.font == &font && entry.characterSize == characterSize && entry.style == style &&
+            entry.outlineThickness == outlineThickness && entry.content == content) {
+            return *entry.text;
+        }
+    }
+
+    // First use: lay the text out once and centre its origin
+    std::string owned(content);
+    auto text = std::make_unique<sf::Text>(font, owned, characterSize);
+    text->setStyle(style);
+    text->setOutlineThickness(outlineThickness);
+
+    sf::FloatRect bounds = text->getLocalBounds();
+    text->setOrigin(sf::Vector2f(
+        bounds.position.x + bounds.size.x / 2.0f,
+        bounds.position.y + bounds.size.y / 2.0f));
+
+    g_textCache.push_back({&font, std::move(owned), characterSize, style, outlineThickness, std::move(text)});
+    return *g_textCache.back().text;
+}
@@ -0,0 +1,25 @@
+#ifndef TEXT_CACHE_H
+#define TEXT_CACHE_H
+
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <string_view>
+
+// Laid-out text objects are kept between frames, keyed by font, string,
+// character size, style and outline thickness. Glyph layout and bounds are
+// computed once when an entry is created; callers only set position and colour.
+// Entries are never dropped, so a returned reference stays valid for the run.
+
+/**
+ * @brief Get a laid-out text object, creating it on first use
+ * @param font Font to render with (must outlive the cache entry)
+ * @param content String to display
+ * @param characterSize Character size in pixels
+ * @param style sf::Text style flags
+ * @param outlineThickness Outline thickness in pixels
+ * @return Text whose origin is already centred on its bounds
+ */
+sf::Text& getCachedText(const sf::Font& font, std::string_view content, unsigned characterSize,
+                        std::uint32_t style = sf::Text::Regular, float outlineThickness = 0.0f);
+
+#endif // TEXT_CACHE_H
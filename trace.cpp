@@ -0,0 +1,134 @@
+#include "trace.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+// One span: begin/end pair stored as a start time and a duration
+struct TraceEvent {
+    const char* name;
+    std::int64_t beginNs; // Since g_epoch
+    std::int64_t durationNs;
+};
+
+// Per-thread ring; only its owning thread writes events
+struct ThreadTrace {
+    int tid;
+    std::atomic<const char*> name;
+    std::atomic<std::uint64_t> written; // Events ever recorded; slot = index % capacity
+    TraceEvent events[TRACE_EVENTS_PER_THREAD];
+};
+
+const TraceClock::time_point g_epoch = TraceClock::now();
+
+// Every buffer ever created, and the ones whose thread has exited
+std::mutex g_registryLock;
+std::vector<std::unique_ptr<ThreadTrace>> g_buffers;
+std::vector<ThreadTrace*> g_freeBuffers;
+
+/**
+ * @brief Hands the calling thread a buffer and returns it to the free list at thread exit
+ */
+struct ThreadTraceHolder {
+    ThreadTrace* trace;
+
+    ThreadTraceHolder() {
+        std::lock_guard<std::mutex> guard(g_registryLock);
+        if (!g_freeBuffers.empty()) {
+            // Keeps the exited thread's events, but not its name
+            trace = g_freeBuffers.back();
+            g_freeBuffers.pop_back();
+            trace->name.store(nullptr, std::memory_order_relaxed);
+        } else {
+            g_buffers.push_back(std::make_unique<ThreadTrace>());
+            trace = g_buffers.back().get();
+            trace->tid = static_cast<int>(g_buffers.size());
+            trace->name.store(nullptr, std::memory_order_relaxed);
+            trace->written.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    ~ThreadTraceHolder() {
+        std::lock_guard<std::mutex> guard(g_registryLock);
+        g_freeBuffers.push_back(trace);
+    }
+};
+
+ThreadTrace& localTrace() {
+    thread_local ThreadTraceHolder holder;
+    return *holder.trace;
+}
+
+std::int64_t sinceEpochNs(TraceClock::time_point t) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(t - g_epoch).count();
+}
+
+void writeJsonString(std::FILE* file, const char* text) {
+    std::fputc('"', file);
+    for (const char* c = text; *c; ++c) {
+        if (*c == '"' || *c == '\\') std::fputc('\\', file);
+        std::fputc(*c, file);
+    }
+    std::fputc('"', file);
+}
+
+} // namespace
+
+void recordTraceEvent(const char* name, TraceClock::time_point begin, TraceClock::time_point end) {
+    ThreadTrace& trace = localTrace();
+    std::uint64_t index = trace.written.load(std::memory_order_relaxed);
+    trace.events[index % TRACE_EVENTS_PER_THREAD] = {name, sinceEpochNs(begin), sinceEpochNs(end) - sinceEpochNs(begin)};
+    trace.written.store(index + 1, std::memory_order_release);
+}
+
+void setTraceThreadName(const char* name) {
+    localTrace().name.store(name, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Write the trace while other threads may still be recording
+ *        Events a thread may have overwritten during the copy are skipped.
+ */
+bool writeTrace(const char* path) {
+    std::FILE* file = std::fopen(path, "w");
+    if (!file) return false;
+
+    std::fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    bool first = true;
+    std::vector<TraceEvent> events;
+
+    std::lock_guard<std::mutex> guard(g_registryLock);
+    for (const std::unique_ptr<ThreadTrace>& trace : g_buffers) {
+        std::uint64_t end = trace->written.load(std::memory_order_acquire);
+        std::uint64_t begin = end > TRACE_EVENTS_PER_THREAD ? end - TRACE_EVENTS_PER_THREAD : 0;
+        events.clear();
+        for (std::uint64_t i = begin; i < end; ++i) {
+            events.push_back(trace->events[i % TRACE_EVENTS_PER_THREAD]);
+        }
+        std::uint64_t after = trace->written.load(std::memory_order_acquire);
+        std::uint64_t firstValid = after + 1 > TRACE_EVENTS_PER_THREAD ? after + 1 - TRACE_EVENTS_PER_THREAD : 0;
+        std::size_t skip = firstValid > begin ? static_cast<std::size_t>(std::min(firstValid, end) - begin) : 0;
+
+        const char* name = trace->name.load(std::memory_order_relaxed);
+        if (name) {
+            std::fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":",
+                         first ? "" : ",\n", trace->tid);
+            writeJsonString(file, name);
+            std::fprintf(file, "}}");
+            first = false;
+        }
+        for (std::size_t i = skip; i < events.size(); ++i) {
+            std::fprintf(file, "%s{\"name\":", first ? "" : ",\n");
+            writeJsonString(file, events[i].name);
+            std::fprintf(file, ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d}",
+                         events[i].beginNs / 1000.0, events[i].durationNs / 1000.0, trace->tid);
+            first = false;
+        }
+    }
+    std::fprintf(file, "\n]}\n");
+    return std::fclose(file) == 0;
+}
@@ -0,0 +1,70 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <chrono>
+#include <cstdint>
+
+// Timeline tracing in the Chrome trace event format (open the output in
+// chrome://tracing or https://ui.perfetto.dev).
+//
+// Compiled in only when CONNECT4_TRACE is defined (make TRACE=1); otherwise
+// every TRACE_* macro expands to nothing. Each thread records into its own
+// ring of the most recent TRACE_EVENTS_PER_THREAD events, so recording
+// never takes a lock. Buffers outlive their threads and are merged when
+// the trace is written; buffers of finished threads are reused by new
+// ones (search helpers come and go every move), keeping their events.
+
+constexpr int TRACE_EVENTS_PER_THREAD = 1 << 16;
+constexpr const char* TRACE_DEFAULT_PATH = "connect4_trace.json";
+
+using TraceClock = std::chrono::steady_clock;
+
+/**
+ * @brief Record one finished span on the calling thread
+ * @param name Static string (only the pointer is stored)
+ */
+void recordTraceEvent(const char* name, TraceClock::time_point begin, TraceClock::time_point end);
+
+/**
+ * @brief Name the calling thread in the trace viewer
+ * @param name Static string
+ */
+void setTraceThreadName(const char* name);
+
+/**
+ * @brief Write every thread's events as a Chrome trace JSON file
+ * @return false if the file could not be written
+ */
+bool writeTrace(const char* path);
+
+/**
+ * @brief Records the span from construction to destruction
+ */
+class TraceScope {
+public:
+    explicit TraceScope(const char* name) : name(name), begin(TraceClock::now()) {}
+    ~TraceScope() { recordTraceEvent(name, begin, TraceClock::now()); }
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* name;
+    TraceClock::time_point begin;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#ifdef CONNECT4_TRACE
+constexpr bool TRACE_ENABLED = true;
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope, __LINE__)(name)
+#define TRACE_EVENT(name, begin, end) recordTraceEvent(name, begin, end)
+#define TRACE_THREAD_NAME(name) setTraceThreadName(name)
+#else
+constexpr bool TRACE_ENABLED = false;
+#define TRACE_SCOPE(name) ((void)0)
+#define TRACE_EVENT(name, begin, end) ((void)0)
+#define TRACE_THREAD_NAME(name) ((void)0)
+#endif
+
+#endif // TRACE_H
@@ -0,0 +1,191 @@
+#include "transposition_table.h"
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#include <malloc.h>
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+namespace {
+
+// Packed data layout: | generation (8) | unused (2) | move + 1 (4) | bound (2) | depth (8) | score (32) |
+constexpr int DEPTH_SHIFT = 32;
+constexpr int BOUND_SHIFT = 40;
+constexpr int MOVE_SHIFT = 42;
+constexpr int GENERATION_SHIFT = 48;
+
+constexpr std::size_t HUGE_PAGE_SIZE = std::size_t(2) << 20;
+
+std::uint64_t packData(int score, int depth, int bound, int bestMove, std::uint8_t generation) {
+    return static_cast<std::uint32_t>(score) |
+           (static_cast<std::uint64_t>(depth & 0xFF) << DEPTH_SHIFT) |
+           (static_cast<std::uint64_t>(bound & 0x3) << BOUND_SHIFT) |
+           (static_cast<std::uint64_t>((bestMove + 1) & 0xF) << MOVE_SHIFT) |
+           (static_cast<std::uint64_t>(generation) << GENERATION_SHIFT);
+}
+
+int dataDepth(std::uint64_t data) { return static_cast<int>((data >> DEPTH_SHIFT) & 0xFF); }
+std::uint8_t dataGeneration(std::uint64_t data) { return static_cast<std::uint8_t>(data >> GENERATION_SHIFT); }
+
+} // namespace
+
+TranspositionTable::TranspositionTable()
+    : buckets(nullptr), bucketCount(0), indexShift(64), replacement(TT_REPLACE_DEPTH_AGE),
+      generation(0), hugePages(false) {}
+
+TranspositionTable::~TranspositionTable() {
+    release();
+}
+
+/**
+ * @brief Reallocate the table (contents are cleared)
+ * @param megabytes Size budget; rounded down to a power-of-two bucket count
+ * @param policy Replacement policy used by store()
+ * @return false if the allocation failed (the table is then empty)
+ */
+bool TranspositionTable::resize(std::size_t megabytes, TTReplacement policy) {
+    release();
+    replacement = policy;
+
+    std::size_t budget = megabytes << 20;
+    std::size_t count = 2;
+    int bits = 1;
+    while (count * 2 * sizeof(Bucket) <= budget) {
+        count *= 2;
+        ++bits;
+    }
+    std::size_t bytes = count * sizeof(Bucket);
+
+    void* memory = nullptr;
+#ifdef _WIN32
+    // Large pages need the "Lock pages in memory" privilege; fall back quietly
+    SIZE_T largePage = GetLargePageMinimum();
+    if (largePage > 0 && bytes % largePage == 0) {
+        memory = VirtualAlloc(nullptr, bytes, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+        hugePages = memory != nullptr;
+    }
+    if (!memory) memory = _aligned_malloc(bytes, 64);
+#else
+    if (bytes >= HUGE_PAGE_SIZE) {
+        memory = std::aligned_alloc(HUGE_PAGE_SIZE, bytes);
+#ifdef MADV_HUGEPAGE
+        // Ask for transparent huge pages so random probes miss the TLB less often
+        hugePages = memory && madvise(memory, bytes, MADV_HUGEPAGE) == 0;
+#endif
+    } else {
+        memory = std::aligned_alloc(64, bytes);
+    }
+#endif
+    if (!memory) return false;
+
+    buckets = static_cast<Bucket*>(memory);
+    for (std::size_t i = 0; i < count; ++i) new (&buckets[i]) Bucket;
+    bucketCount = count;
+    indexShift = 64 - bits;
+    clear();
+    return true;
+}
+
+/**
+ * @brief Wipe every slot (not safe while searches are running)
+ */
+void TranspositionTable::clear() {
+    for (std::size_t i = 0; i < bucketCount; ++i) {
+        for (Slot& slot : buckets[i].slots) {
+            slot.check.store(0, std::memory_order_relaxed);
+            slot.data.store(0, std::memory_order_relaxed);
+        }
+    }
+    generation.store(0, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Start a new root search so older entries age out first
+ */
+void TranspositionTable::newSearch() {
+    generation.fetch_add(1, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Look a position up
+ * @return true if a verified entry with a usable bound was found
+ */
+bool TranspositionTable::probe(std::uint64_t key, TTHit& hit) const {
+    if (!buckets) return false;
+    const Bucket& bucket = bucketFor(key);
+    for (const Slot& slot : bucket.slots) {
+        std::uint64_t data = slot.data.load(std::memory_order_relaxed);
+        std::uint64_t check = slot.check.load(std::memory_order_relaxed);
+        if ((check ^ data) != key) continue;
+
+        int bound = static_cast<int>((data >> BOUND_SHIFT) & 0x3);
+        if (bound == TT_BOUND_NONE) return false;
+        hit.score = static_cast<std::int32_t>(static_cast<std::uint32_t>(data));
+        hit.depth = dataDepth(data);
+        hit.bound = bound;
+        hit.bestMove = static_cast<int>((data >> MOVE_SHIFT) & 0xF) - 1;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Record a search result (lock-free; concurrent stores may overwrite each other)
+ */
+void TranspositionTable::store(std::uint64_t key, int score, int depth, int bound, int bestMove) {
+    if (!buckets) return;
+    Bucket& bucket = bucketFor(key);
+
+    int target = -1;
+    for (int i = 0; i < 2; ++i) {
+        Slot& slot = bucket.slots[i];
+        std::uint64_t data = slot.data.load(std::memory_order_relaxed);
+        if ((slot.check.load(std::memory_order_relaxed) ^ data) == key) {
+            target = i;
+            break;
+        }
+    }
+
+    if (target < 0) {
+        if (replacement == TT_REPLACE_ALWAYS) {
+            target = 0;
+        } else {
+            // Evict the slot worth least: entries from older searches count as shallow
+            std::uint8_t current = generation.load(std::memory_order_relaxed);
+            int worth[2];
+            for (int i = 0; i < 2; ++i) {
+                std::uint64_t data = bucket.slots[i].data.load(std::memory_order_relaxed);
+                worth[i] = dataDepth(data) - (dataGeneration(data) != current ? 256 : 0);
+            }
+            target = (worth[1] < worth[0]) ? 1 : 0;
+        }
+    }
+
+    std::uint64_t data = packData(score, depth, bound, bestMove, generation.load(std::memory_order_relaxed));
+    Slot& slot = bucket.slots[target];
+    slot.data.store(data, std::memory_order_relaxed);
+    slot.check.store(key ^ data, std::memory_order_relaxed);
+}
+
+TranspositionTable::Bucket& TranspositionTable::bucketFor(std::uint64_t key) const {
+    // Fibonacci hashing spreads the structured bitboard keys across the table
+    return buckets[(key * 0x9E3779B97F4A7C15ull) >> indexShift];
+}
+
+void TranspositionTable::release() {
+    if (!buckets) return;
+    for (std::size_t i = 0; i < bucketCount; ++i) buckets[i].~Bucket();
+#ifdef _WIN32
+    if (hugePages) VirtualFree(buckets, 0, MEM_RELEASE);
+    else _aligned_free(buckets);
+#else
+    std::free(buckets);
+#endif
+    buckets = nullptr;
+    bucketCount = 0;
+    indexShift = 64;
+    hugePages = false;
+}
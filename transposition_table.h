@@ -0,0 +1,70 @@
+#ifndef TRANSPOSITION_TABLE_H
+#define TRANSPOSITION_TABLE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// How a store chooses which slot of a bucket to overwrite
+enum TTReplacement {
+    TT_REPLACE_ALWAYS,    // Newest result always wins the bucket's first slot
+    TT_REPLACE_DEPTH_AGE  // Keep deep entries from the current search, evict shallow or stale ones
+};
+
+// Bound stored with a score
+enum TTBound { TT_BOUND_NONE, TT_BOUND_EXACT, TT_BOUND_LOWER, TT_BOUND_UPPER };
+
+// Decoded table entry
+struct TTHit {
+    int score;
+    int depth;
+    int bound;
+    int bestMove; // -1 if none
+};
+
+/**
+ * @brief Lock-free transposition table shared by all search threads
+ *
+ * Every slot holds two 64-bit atomics: the packed data and (key XOR data).
+ * A reader accepts a slot only if the XOR of the two words gives back its
+ * key, so a slot torn by two concurrent writers is simply treated as a miss.
+ */
+class TranspositionTable {
+public:
+    TranspositionTable();
+    ~TranspositionTable();
+    TranspositionTable(const TranspositionTable&) = delete;
+    TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+    bool resize(std::size_t megabytes, TTReplacement policy);
+    void clear();
+    void newSearch();
+
+    bool probe(std::uint64_t key, TTHit& hit) const;
+    void store(std::uint64_t key, int score, int depth, int bound, int bestMove);
+
+    std::size_t sizeBytes() const { return bucketCount * sizeof(Bucket); }
+    bool usesHugePages() const { return hugePages; }
+    bool isAllocated() const { return buckets != nullptr; }
+
+private:
+    struct Slot {
+        std::atomic<std::uint64_t> check; // key ^ data
+        std::atomic<std::uint64_t> data;
+    };
+    struct alignas(32) Bucket {
+        Slot slots[2];
+    };
+
+    Bucket& bucketFor(std::uint64_t key) const;
+    void release();
+
+    Bucket* buckets;
+    std::size_t bucketCount;
+    int indexShift;
+    TTReplacement replacement;
+    std::atomic<std::uint8_t> generation;
+    bool hugePages;
+};
+
+#endif // TRANSPOSITION_TABLE_H